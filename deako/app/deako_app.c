@@ -2,11 +2,57 @@
 #include "deako_pch.h"
 
 #include "deako.h"
+#include "jobs/deako_jobs.h"
+#include "renderer/deako_renderer.h"
 
 #include <malloc.h>
 #include <stdint.h>
+#include <string.h>
+
+#define DK_APP_ARENA_RESERVE (256ull * 1024 * 1024)
+#define DK_APP_REQUEST_RESERVE (64ull * 1024 * 1024) // the request pool's own arena
 
 static dk_app_t* g_app = NULL;
+static dk_mutex_t g_log_mutex;
+
+/* layers may now log from job workers */
+static void _dk_app_log_lock(bool lock, void* udata)
+{
+    if (lock)
+    {
+        dk_mutex_lock((dk_mutex_t*)udata);
+    }
+    else
+    {
+        dk_mutex_unlock((dk_mutex_t*)udata);
+    }
+}
+
+/* layers become bus subscribers in declaration order */
+static int _dk_app_bus_init(void)
+{
+    int status = DK_ERRNO_UNKNOWN;
+    DK_SCRATCH_SCOPE(scratch, NULL)
+    {
+        uint32_t count                   = g_app->layer_count;
+        dk_bus_subscriber_t* subscribers = dk_scratch_alloc(&scratch, (count ? count : 1) * sizeof(*subscribers), 8);
+        if (subscribers)
+        {
+            for (uint32_t i = 0; i < count; i++)
+            {
+                subscribers[i].on_request = g_app->layers[i].on_request;
+                subscribers[i].topics     = g_app->layers[i].topics;
+            }
+            status = _dk_bus_init(&g_app->bus, &g_app->arena, g_app->events->capacity, subscribers, count);
+        }
+    }
+    return status;
+}
+
+static void _dk_app_reload_poll(void)
+{
+    _dk_app_reload_check(g_app);
+}
 
 int _dk_app_init(const dk_config_t* config)
 {
@@ -14,54 +60,297 @@ int _dk_app_init(const dk_config_t* config)
 
     g_app = malloc(sizeof(*g_app)); // temp
     DK_CHECK(g_app, DK_ERRNO_UNKNOWN);
+    _dk_startup_begin(&g_app->startup, config->startup_trace_path);
 
-    g_app->layers      = config->app_layers;
-    g_app->layer_count = config->app_layer_count;
+    g_app->layers         = config->app_layers;
+    g_app->layer_count    = config->app_layer_count;
+    g_app->is_running     = true;
+    g_app->is_headless    = config->headless || config->replay_path;
+    g_app->glfw_window    = NULL;
+    g_app->input          = NULL;
+    g_app->clock_mode     = config->replay_path ? DK_CLOCK_MODE_REPLAY : config->clock_mode;
+    g_app->clock          = config->clock;
+    g_app->simulated_time = 0;
+    g_app->frame_count    = 0;
+    g_app->frame_limit    = config->frame_limit;
+    g_app->profile_path   = config->profile_path;
+    g_app->layer_stats    = NULL;
+    memset(&g_app->modules, 0, sizeof(g_app->modules));
+
+    DK_CHECK(g_app->clock_mode != DK_CLOCK_MODE_CUSTOM || g_app->clock, DK_ERRNO_UNKNOWN);
+
+    dk_mutex_init(&g_log_mutex);
+    log_set_lock(_dk_app_log_lock, &g_log_mutex);
+    if (config->log_async || config->log_binary)
+    {
+        int status = _dk_log_init(config->log_policy, config->log_ring_size, config->log_binary);
+        DK_STATUS(status);
+    }
 
-    _dk_app_window_init(g_app, config->window_width, config->window_height, config->app_name);
+    dk_profile_thread_name("main");
+    _dk_startup_mark(&g_app->startup, "log");
 
-    g_app->timer.timeout  = 0;
-    g_app->timer.timestep = 16; // ms
+    uint64_t time;
+    _dk_app_time_update(&time);
+
+    g_app->timer.timeout  = time;
+    g_app->timer.timestep = DK_NS_PER_S / (config->frame_rate ? config->frame_rate : 60);
     g_app->timer.callback = _dk_app_layer_update;
 
-    dk_module_t renderer = {
-        .name  = "VULKAN_RENDERER",
-        .type  = DK_MODULE_TYPE_RENDERER,
-        .flags = DK_RENDERER_FLAG_VULKAN,
+    _dk_app_pacer_init(&g_app->pacer, config->pacer_mode, g_app->is_headless);
+    _dk_app_timestep_init(&g_app->timestep, config->tick_rate, time);
+    g_app->start_time = time;
+
+    g_app->replay.mode = DK_REPLAY_MODE_NONE;
+    g_app->replay.file = NULL;
+    if (config->replay_path)
+    {
+        int status = _dk_replay_open(&g_app->replay, DK_REPLAY_MODE_PLAY, config->replay_path, 0, 0);
+        DK_STATUS(status);
+        g_app->timer.timestep = g_app->replay.header.timestep; // same frame deadlines as the recording
+        _dk_app_timestep_init(&g_app->timestep, g_app->replay.header.tick_rate, time);
+    }
+    else if (config->record_path)
+    {
+        int status = _dk_replay_open(
+        &g_app->replay, DK_REPLAY_MODE_RECORD, config->record_path, g_app->timer.timestep, config->tick_rate);
+        DK_STATUS(status);
+    }
+
+    int status = _dk_timer_wheel_init(&g_app->timers, time);
+    DK_STATUS(status);
+
+    status = _dk_app_layer_graph_init(&g_app->layer_graph, g_app->layers, g_app->layer_count);
+    DK_STATUS(status);
+    _dk_startup_mark(&g_app->startup, "timing");
+
+    uint32_t frame_flags = config->frame_arena_huge_pages ? DK_ARENA_FLAG_HUGE_PAGES : DK_ARENA_FLAG_NONE;
+    status = _dk_frame_arena_init(&g_app->frame_arena, config->frame_arena_buffers, config->frame_arena_reserve, frame_flags);
+    DK_STATUS(status);
+
+    status = dk_arena_init_virtual(&g_app->arena, DK_APP_ARENA_RESERVE, DK_ARENA_FLAG_NONE);
+    DK_STATUS(status);
+    dk_arena_track(&g_app->arena, "APP");
+
+    /* the pool carves its arena with atomics from any thread, nothing else may allocate from
+     * it, so it doesn't share the app arena */
+    status = dk_arena_init_virtual(&g_app->request_arena, DK_APP_REQUEST_RESERVE, DK_ARENA_FLAG_NONE);
+    DK_STATUS(status);
+    dk_arena_track(&g_app->request_arena, "REQUESTS");
+    status = DK_POOL_INIT_TYPE(&g_app->requests, &g_app->request_arena, dk_request_slot_t);
+    DK_STATUS(status);
+    g_app->request_jobs       = (dk_job_counter_t){ 0 };
+    g_app->completed          = NULL;
+    g_app->active_requests    = 0;
+    g_app->requests_completed = 0;
+    _dk_startup_mark(&g_app->startup, "memory");
+
+    /* before the bus copies the layers' on_request */
+    status = _dk_app_reload_init(g_app);
+    DK_STATUS(status);
+    if (g_app->reload.library_count)
+    {
+        g_app->reload.timer = dk_timer_schedule_repeat(DK_RELOAD_POLL, DK_RELOAD_POLL, _dk_app_reload_poll);
+    }
+
+    g_app->events = dk_arena_alloc(&g_app->arena, sizeof(*g_app->events), DK_CACHE_LINE);
+    DK_CHECK(g_app->events, DK_ERRNO_UNKNOWN);
+    status = _dk_event_queue_init(g_app->events, &g_app->arena, config->request_capacity);
+    DK_STATUS(status);
+    status = _dk_app_bus_init();
+    DK_STATUS(status);
+    status = _dk_app_input_init(g_app);
+    DK_STATUS(status);
+
+    uint64_t wall = dk_clock_now_ns();
+    _dk_app_stats_init(&g_app->frame_stats, wall);
+    if (config->layer_stats && g_app->layer_count)
+    {
+        g_app->layer_stats = malloc(g_app->layer_count * sizeof(*g_app->layer_stats));
+        DK_CHECK(g_app->layer_stats, DK_ERRNO_UNKNOWN);
+        for (uint32_t i = 0; i < g_app->layer_count; i++)
+        {
+            _dk_app_stats_init(&g_app->layer_stats[i], wall);
+        }
+    }
+    _dk_startup_mark(&g_app->startup, "events");
+
+    /* after the input buffers its callbacks write to */
+    if (!g_app->is_headless)
+    {
+        status = _dk_app_window_init(g_app, config->window_width, config->window_height, config->app_name);
+        DK_STATUS(status);
+    }
+    _dk_startup_mark(&g_app->startup, "window");
+
+    dk_jobs_t jobs = {
+        .name         = "JOBS",
+        .type         = DK_MODULE_TYPE_JOBS,
+        .worker_count = config->job_workers,
     };
+    status = _dk_module_register(&g_app->modules, &g_app->arena, (dk_module_t*)&jobs, sizeof(jobs));
+    DK_STATUS(status);
 
-    int status = _dk_module_init(g_app, &renderer);
+    dk_renderer_t renderer = {
+        .name    = "VULKAN_RENDERER",
+        .type    = DK_MODULE_TYPE_RENDERER,
+        .depends = DK_MODULE_BIT(DK_MODULE_TYPE_JOBS),
+        .flags   = DK_RENDERER_FLAG_VULKAN | DK_MODULE_FLAG_TLSF | (g_app->is_headless ? DK_MODULE_FLAG_LAZY : 0),
+    }; // nothing to present headless, the first frame need not wait for it
+    status = _dk_module_register(&g_app->modules, &g_app->arena, (dk_module_t*)&renderer, sizeof(renderer));
     DK_STATUS(status);
 
+    status = _dk_modules_init(&g_app->modules);
+    DK_STATUS(status);
+    _dk_modules_report(&g_app->modules);
+    _dk_startup_mark(&g_app->startup, "modules");
+
     return DK_STATUS_OK;
 }
 
+/* The next recorded frame time, or a timer due before it. Never earlier than the frame
+ * deadline, a replay that drifted still makes progress. */
+static uint64_t _dk_app_replay_deadline(void)
+{
+    uint64_t next = g_app->replay.has_next ? g_app->replay.next.time : g_app->timer.timeout;
+    next          = (next > g_app->timer.timeout) ? next : g_app->timer.timeout;
+
+    uint64_t timers = _dk_timer_wheel_next_deadline(&g_app->timers);
+    next            = (timers < next) ? timers : next;
+    return (next > g_app->simulated_time) ? next : g_app->simulated_time;
+}
+
+/* the startup trace ends here, lazy modules nobody needed yet start in the background */
+static void _dk_app_first_frame(void)
+{
+    _dk_startup_mark(&g_app->startup, "first frame");
+    _dk_startup_write(&g_app->startup, &g_app->modules);
+    _dk_modules_start_deferred(&g_app->modules);
+}
+
 int _dk_app_run(void)
 {
     uint64_t time;
+    uint64_t begin = dk_clock_now_ns();
 
     int status = _dk_app_status_update();
     while (status == DK_STATUS_RUN)
     {
-        _dk_app_window_poll();
+        if (!g_app->is_headless)
+        {
+            _dk_app_window_poll();
+        }
 
         _dk_app_time_update(&time);
-        if (time >= g_app->timer.timeout)
+        _dk_timer_wheel_update(&g_app->timers, time);
+
+        if (time >= g_app->timer.timeout || g_app->pacer.mode == DK_PACER_MODE_UNCAPPED)
         {
-            g_app->timer.timeout = time + g_app->timer.timestep;
+            _dk_app_pacer_record(&g_app->pacer, g_app->timer.timeout, time);
+            g_app->timer.timeout += g_app->timer.timestep;
+            if (g_app->timer.timeout <= time)
+            {
+                g_app->timer.timeout = time + g_app->timer.timestep; // fell behind, don't burst
+            }
+
+            _dk_frame_arena_begin(&g_app->frame_arena);
+            _dk_arena_stats_frame();
+            _dk_app_request_complete();
+            _dk_app_input_flush(g_app, time);
+            _dk_app_request_dispatch();
+
+            uint64_t frame_begin = dk_clock_now_ns();
             g_app->timer.callback();
-            static int frame = 0;
-            DK_INFO("app layers updated at: %llu ms (frame %d)\n", g_app->timer.timeout, frame++);
+            uint64_t frame_end = dk_clock_now_ns();
+            _dk_app_stats_record(&g_app->frame_stats, frame_end - frame_begin, frame_end);
+            for (uint32_t i = 0; g_app->layer_stats && i < g_app->layer_count; i++)
+            {
+                _dk_app_stats_rotate(&g_app->layer_stats[i], frame_end); // layers that stopped updating too
+            }
+
+            if (++g_app->frame_count == 1)
+            {
+                _dk_app_first_frame();
+            }
+            if (g_app->frame_count == g_app->frame_limit)
+            {
+                g_app->is_running = false;
+            }
+        }
+
+        uint64_t deadline = _dk_timer_wheel_next_deadline(&g_app->timers);
+        deadline          = (deadline < g_app->timer.timeout) ? deadline : g_app->timer.timeout;
+        if (g_app->clock_mode == DK_CLOCK_MODE_SIMULATED)
+        {
+            g_app->simulated_time = deadline;
+        }
+        else if (g_app->clock_mode == DK_CLOCK_MODE_REPLAY)
+        {
+            g_app->simulated_time = _dk_app_replay_deadline();
+        }
+        else
+        {
+            _dk_app_time_update(&time);
+            _dk_app_pacer_wait(&g_app->pacer, time, deadline);
         }
 
         status = _dk_app_status_update();
     }
 
+    uint64_t elapsed = dk_clock_now_ns() - begin;
+    if (elapsed)
+    {
+        DK_INFO("app: %llu frames in %.3f s (%.1f frames/s)", (unsigned long long)g_app->frame_count,
+        (double)elapsed / DK_NS_PER_S, (double)g_app->frame_count * DK_NS_PER_S / (double)elapsed);
+    }
+
     return status;
 }
 
 int _dk_app_shutdown(void)
 {
+    _dk_app_request_drain();
+    _dk_app_reload_shutdown(g_app);
+
+    _dk_app_pacer_report(&g_app->pacer);
+    _dk_app_stats_report("frame", &g_app->frame_stats);
+    for (uint32_t i = 0; g_app->layer_stats && i < g_app->layer_count; i++)
+    {
+        _dk_app_stats_report(g_app->layers[i].name, &g_app->layer_stats[i]);
+    }
+    free(g_app->layer_stats);
+    g_app->layer_stats = NULL;
+    _dk_app_layer_graph_shutdown(&g_app->layer_graph);
+    DK_INFO("timestep: %llu ticks, %.3f ms dropped", (unsigned long long)g_app->timestep.tick_count,
+    (double)g_app->timestep.dropped / DK_NS_PER_MS);
+
+    _dk_timer_wheel_shutdown(&g_app->timers);
+
+    _dk_modules_shutdown(&g_app->modules);
+
+    _dk_frame_arena_report(&g_app->frame_arena);
+    _dk_frame_arena_shutdown(&g_app->frame_arena);
+    _dk_scratch_shutdown();
+    _dk_event_report(g_app->events);
+    _dk_bus_report(&g_app->bus);
+    _dk_app_input_report(g_app);
+    _dk_replay_close(&g_app->replay);
+    DK_INFO("requests: %llu completed", (unsigned long long)g_app->requests_completed);
+    dk_pool_shutdown(&g_app->requests);
+    dk_arena_shutdown(&g_app->request_arena);
+    dk_arena_shutdown(&g_app->arena);
+    _dk_arena_stats_report();
+
+    if (g_app->profile_path)
+    {
+        dk_profile_dump(g_app->profile_path);
+    }
+    _dk_profiler_shutdown();
+
+    _dk_log_shutdown();
+    log_set_lock(NULL, NULL);
+    dk_mutex_destroy(&g_log_mutex);
+
     return DK_STATUS_OK;
 }
 
@@ -70,18 +359,290 @@ int _dk_app_status_update(void)
     return g_app->is_running ? DK_STATUS_RUN : DK_STATUS_OK;
 }
 
-void _dk_app_layer_update(void)
+static void _dk_app_layer_on_update(void* data)
 {
-    for (uint32_t i = 0; i < g_app->layer_count; i++)
+    uint32_t i = (uint32_t)(uintptr_t)data;
+    if (!g_app->layers[i].on_update)
     {
-        if (g_app->layers[i].on_update)
+        return;
+    }
+
+    uint64_t begin = g_app->layer_stats ? dk_clock_now_ns() : 0;
+    DK_PROFILE_SCOPE(g_app->layers[i].name)
+    {
+        g_app->layers[i].on_update();
+    }
+    if (g_app->layer_stats)
+    {
+        uint64_t end = dk_clock_now_ns();
+        _dk_app_stats_record(&g_app->layer_stats[i], end - begin, end);
+    }
+}
+
+static void _dk_app_layer_on_fixed_update(void* data)
+{
+    uint32_t i = (uint32_t)(uintptr_t)data;
+    if (g_app->layers[i].on_fixed_update)
+    {
+        DK_PROFILE_SCOPE(g_app->layers[i].name)
+        {
+            g_app->layers[i].on_fixed_update();
+        }
+    }
+}
+
+static void _dk_app_layer_run(dk_job_fn fn)
+{
+    dk_layer_graph_t* graph = &g_app->layer_graph;
+
+    for (uint32_t w = 0; w < graph->wave_count; w++)
+    {
+        uint32_t begin = graph->waves[w];
+        uint32_t count = graph->waves[w + 1] - begin;
+        if (count == 1)
+        {
+            fn((void*)(uintptr_t)graph->order[begin]);
+            continue;
+        }
+
+        for (uint32_t i = 0; i < count; i++)
         {
-            g_app->layers[i].on_update();
+            graph->decls[i].fn   = fn;
+            graph->decls[i].data = (void*)(uintptr_t)graph->order[begin + i];
         }
+
+        dk_job_counter_t counter = { 0 };
+        dk_jobs_run(graph->decls, count, &counter);
+        dk_jobs_wait(&counter);
+    }
+}
+
+void _dk_app_request_dispatch(void)
+{
+    const dk_request_t* requests;
+    uint32_t count = _dk_event_collect(g_app->events, &requests);
+    if (count == 0)
+    {
+        return;
+    }
+
+    DK_PROFILE_SCOPE("_dk_app_request_dispatch")
+    {
+        _dk_bus_publish(&g_app->bus, requests, count);
+    }
+}
+
+void _dk_app_layer_update(void)
+{
+    DK_PROFILE_BEGIN("_dk_app_layer_update");
+
+    uint64_t time;
+    _dk_app_time_update(&time);
+
+    uint32_t ticks = _dk_app_timestep_advance(&g_app->timestep, time);
+    for (uint32_t tick = 0; tick < ticks; tick++)
+    {
+        _dk_app_layer_fixed_update();
     }
+
+    _dk_app_layer_run(_dk_app_layer_on_update);
+
+    DK_PROFILE_END("_dk_app_layer_update");
+}
+
+void _dk_app_layer_fixed_update(void)
+{
+    _dk_app_layer_run(_dk_app_layer_on_fixed_update);
 }
 
 void _dk_app_time_update(uint64_t* time)
 {
-    *time = (uint64_t)(glfwGetTime() * 1000); // ms
+    switch (g_app->clock_mode)
+    {
+    case DK_CLOCK_MODE_REAL: *time = dk_clock_now_ns(); break;
+    case DK_CLOCK_MODE_SIMULATED:
+    case DK_CLOCK_MODE_REPLAY: *time = g_app->simulated_time; break;
+    case DK_CLOCK_MODE_CUSTOM: *time = g_app->clock(); break;
+    }
+}
+
+int dk_app_frame_stats(dk_frame_stats_t* stats, bool window)
+{
+    DK_CHECK(stats, DK_ERRNO_UNKNOWN);
+    _dk_app_stats_query(&g_app->frame_stats, window, stats);
+    return DK_STATUS_OK;
+}
+
+int dk_app_layer_stats(uint32_t layer, dk_frame_stats_t* stats, bool window)
+{
+    DK_CHECK(stats && g_app->layer_stats && layer < g_app->layer_count, DK_ERRNO_UNKNOWN);
+    _dk_app_stats_query(&g_app->layer_stats[layer], window, stats);
+    return DK_STATUS_OK;
+}
+
+double dk_app_tick_delta(void)
+{
+    return (double)g_app->timestep.step / (double)DK_NS_PER_S;
+}
+
+double dk_app_tick_alpha(void)
+{
+    return g_app->timestep.alpha;
+}
+
+dk_timer_handle_t dk_timer_schedule(uint64_t delay, dk_timer_cb callback)
+{
+    uint64_t time;
+    _dk_app_time_update(&time);
+    return _dk_timer_wheel_schedule(&g_app->timers, time + delay, 0, callback);
+}
+
+dk_timer_handle_t dk_timer_schedule_repeat(uint64_t delay, uint64_t interval, dk_timer_cb callback)
+{
+    uint64_t time;
+    _dk_app_time_update(&time);
+    return _dk_timer_wheel_schedule(&g_app->timers, time + delay, interval, callback);
+}
+
+bool dk_timer_cancel(dk_timer_handle_t handle)
+{
+    return _dk_timer_wheel_cancel(&g_app->timers, handle);
+}
+
+void* dk_frame_alloc(uint64_t size)
+{
+    return _dk_frame_arena_alloc(&g_app->frame_arena, size, DK_ARENA_ALIGN);
+}
+
+void* dk_frame_alloc_aligned(uint64_t size, uint64_t align)
+{
+    return _dk_frame_arena_alloc(&g_app->frame_arena, size, align);
+}
+
+uint64_t dk_frame_high_water(void)
+{
+    uint64_t high_water = g_app->frame_arena.high_water;
+    uint64_t current    = g_app->frame_arena.buffers[g_app->frame_arena.index].offset;
+    return (current > high_water) ? current : high_water;
+}
+
+bool dk_request_post(const dk_request_t* request)
+{
+    dk_request_t stamped = *request;
+    if (stamped.time == 0)
+    {
+        _dk_app_time_update(&stamped.time);
+    }
+
+    return _dk_event_post(g_app->events, &stamped);
+}
+
+dk_request_t* dk_request_alloc(void)
+{
+    dk_request_slot_t* slot = DK_POOL_NEW(&g_app->requests, dk_request_slot_t);
+    if (!slot)
+    {
+        return NULL;
+    }
+
+    memset(slot, 0, sizeof(*slot));
+    return &slot->request;
+}
+
+void dk_request_free(dk_request_t* request)
+{
+    dk_pool_free(&g_app->requests, (dk_request_slot_t*)request);
+}
+
+static void _dk_app_request_execute(void* data)
+{
+    dk_request_slot_t* slot = data;
+    slot->execute(&slot->request);
+
+    void* head = dk_atomic_load_ptr(&g_app->completed);
+    do
+    {
+        slot->next = head;
+    } while (!dk_atomic_cas_ptr(&g_app->completed, &head, slot));
+}
+
+int dk_request_submit(dk_request_t* request, dk_request_cb execute, dk_request_cb complete)
+{
+    DK_CHECK(request && execute, DK_ERRNO_UNKNOWN);
+
+    dk_request_slot_t* slot = (dk_request_slot_t*)request;
+    slot->execute           = execute;
+    slot->complete          = complete;
+    if (request->time == 0)
+    {
+        _dk_app_time_update(&request->time);
+    }
+
+    dk_atomic_add_u32(&g_app->active_requests, 1);
+
+    dk_job_decl_t decl = { _dk_app_request_execute, slot };
+    dk_jobs_run(&decl, 1, &g_app->request_jobs);
+
+    return DK_STATUS_OK;
+}
+
+uint32_t dk_request_active(void)
+{
+    return dk_atomic_load_u32(&g_app->active_requests);
+}
+
+dk_module_t* dk_app_module(dk_module_type type)
+{
+    return _dk_module_require(&g_app->modules, type);
+}
+
+const dk_input_t* dk_app_input(void)
+{
+    return g_app->snapshot;
+}
+
+/* completions run in the order the requests finished executing */
+void _dk_app_request_complete(void)
+{
+    dk_request_slot_t* slot = dk_atomic_exchange_ptr(&g_app->completed, NULL);
+    if (!slot)
+    {
+        return;
+    }
+
+    dk_request_slot_t* ordered = NULL;
+    while (slot)
+    {
+        dk_request_slot_t* next = slot->next;
+        slot->next              = ordered;
+        ordered                 = slot;
+        slot                    = next;
+    }
+
+    DK_PROFILE_SCOPE("_dk_app_request_complete")
+    {
+        while (ordered)
+        {
+            dk_request_slot_t* next = ordered->next;
+            if (ordered->complete)
+            {
+                ordered->complete(&ordered->request);
+            }
+
+            dk_request_free(&ordered->request);
+            dk_atomic_add_u32(&g_app->active_requests, (uint32_t)-1);
+            g_app->requests_completed++;
+            ordered = next;
+        }
+    }
+}
+
+/* completions may submit follow-up requests, keep going until none are left */
+void _dk_app_request_drain(void)
+{
+    while (dk_atomic_load_u32(&g_app->active_requests))
+    {
+        dk_jobs_wait(&g_app->request_jobs);
+        _dk_app_request_complete();
+    }
 }
@@ -1,7 +1,20 @@
 #ifndef DEAKO_APP_H
 #define DEAKO_APP_H
 
+#include "deako_input.h"
 #include "deako_internal.h"
+#include "deako_module.h"
+#include "deako_reload.h"
+#include "deako_replay.h"
+#include "deako_startup.h"
+#include "deako_timer.h"
+#include "event/deako_bus.h"
+#include "event/deako_event.h"
+#include "jobs/deako_jobs.h"
+#include "memory/deako_handle_pool.h"
+#include "memory/deako_pool.h"
+#include "memory/deako_scratch.h"
+#include "profiler/deako_histogram.h"
 
 #include <GLFW/glfw3.h>
 
@@ -9,28 +22,151 @@
 
 typedef struct dk_config dk_config_t;
 
-typedef void (*dk_on_update_cb)();
-
 typedef struct dk_window {
     dk_module_t module;
     dk_on_request_cb on_request;
 } dk_window_t;
 
+typedef enum dk_pacer_mode {
+    DK_PACER_MODE_HYBRID = 0, /* default: sleep most of the interval, spin the tail */
+    DK_PACER_MODE_SLEEP,
+    DK_PACER_MODE_SPIN,
+    DK_PACER_MODE_UNCAPPED,
+} dk_pacer_mode;
+
+typedef enum dk_clock_mode {
+    DK_CLOCK_MODE_REAL = 0,  /* dk_clock_now_ns */
+    DK_CLOCK_MODE_SIMULATED, /* jumps straight to the next deadline, deterministic and never waits */
+    DK_CLOCK_MODE_CUSTOM,    /* dk_config_t.clock */
+    DK_CLOCK_MODE_REPLAY,    /* frame times from the recording in dk_config_t.replay_path */
+} dk_clock_mode;
+
+typedef struct dk_pacer {
+    dk_pacer_mode mode;
+    bool headless; // no window events to wait on, sleep instead
+    uint64_t spin_threshold; // ns
+    uint64_t frame_count;
+    uint64_t jitter_sum; // ns
+    uint64_t jitter_max; // ns
+} dk_pacer_t;
+
+typedef struct dk_timestep {
+    uint64_t step;        // ns
+    uint64_t accumulator; // ns
+    uint64_t previous;    // ns
+    uint64_t tick_count;
+    uint64_t dropped;  // ns discarded by the max_ticks clamp
+    uint32_t max_ticks; // catch-up ticks per frame before time is dropped
+    double alpha;
+} dk_timestep_t;
+
+typedef struct dk_stats {
+    dk_histogram_t total;
+    dk_histogram_t window;   // filling up
+    dk_histogram_t previous; // last complete window
+    uint64_t window_start;   // ns
+} dk_stats_t;
+
+typedef struct dk_frame_stats {
+    uint64_t count;
+    uint64_t mean; // ns
+    uint64_t p50;  // ns
+    uint64_t p95;  // ns
+    uint64_t p99;  // ns
+    uint64_t max;  // ns
+} dk_frame_stats_t;
+
+#define DK_FRAME_ARENA_MAX 3
+
+/* Per-frame scratch memory, rotated through count buffers so an allocation stays valid for
+ * count - 1 frames after the one it was made in. Each buffer is a virtual arena committed as
+ * it fills; allocations past its reservation fall back to malloc and are freed when their
+ * buffer comes round again. */
+typedef struct dk_frame_arena {
+    dk_arena_t buffers[DK_FRAME_ARENA_MAX];
+    void* volatile spills[DK_FRAME_ARENA_MAX]; // malloc fallbacks per buffer
+    volatile uint64_t spilled[DK_FRAME_ARENA_MAX];
+    volatile uint64_t spill_count;
+    volatile uint64_t spill_bytes;
+    uint64_t high_water; // most bytes any one frame used, fallbacks included
+    uint64_t frame_count;
+    uint32_t count;
+    uint32_t index;
+} dk_frame_arena_t;
+
+typedef void (*dk_request_cb)(dk_request_t* request);
+
+/* What dk_request_alloc hands out, the request first so one converts to the other. */
+typedef struct dk_request_slot {
+    dk_request_t request;
+    dk_request_cb execute;        // on a job worker
+    dk_request_cb complete;       // on the main thread, NULL = none
+    struct dk_request_slot* next; // completion list
+} dk_request_slot_t;
+
+#define DK_RESOURCE(n) ((uint64_t)1 << (n))
+
+/* reads/writes are app-defined DK_RESOURCE bits. Layers whose sets don't conflict may
+ * update concurrently; a layer that declares neither runs alone, in declaration order. */
 typedef struct dk_layer {
     const char* name;
     dk_on_update_cb on_update;
     dk_on_request_cb on_request;
+    dk_on_update_cb on_fixed_update;
+    uint64_t reads;
+    uint64_t writes;
+    uint64_t topics; // DK_TOPIC() of the request types on_request wants, 0 = all in one batch
+    const char* library; // shared library the callbacks come from and are reloaded from, NULL = static
 } dk_layer_t;
 
+/* layers grouped into waves, a wave only starts once every earlier one has finished */
+typedef struct dk_layer_graph {
+    uint32_t* order; // layer indices, wave by wave
+    uint32_t* waves; // wave_count + 1 offsets into order
+    uint32_t wave_count;
+    dk_job_decl_t* decls;
+} dk_layer_graph_t;
+
 typedef struct dk_app {
     dk_timer_t timer;
+    dk_pacer_t pacer;
+    dk_timestep_t timestep;
+    dk_timer_wheel_t timers;
+    dk_clock_mode clock_mode;
+    dk_clock_cb clock;
+    uint64_t simulated_time; // ns
+    uint64_t start_time;     // ns, the clock when the app started
+    uint64_t frame_count;
+    uint64_t frame_limit;
+    dk_stats_t frame_stats;
+    dk_stats_t* layer_stats; // NULL unless dk_config_t.layer_stats
+    dk_layer_graph_t layer_graph;
+    dk_frame_arena_t frame_arena;
+    dk_arena_t arena;         // app lifetime memory
+    dk_arena_t request_arena; // only ever carved by requests
+    dk_pool_t requests;       // dk_request_slot_t
+    dk_event_queue_t* events;
+    dk_bus_t bus; // routes each frame's requests to the layers' on_request
+    dk_job_counter_t request_jobs; // submitted requests still executing
+    void* volatile completed;      // dk_request_slot_t list, newest first
+    uint64_t requests_completed;
+    dk_input_t* inputs;   // two, swapped every frame
+    dk_input_t* input;    // capturing, the window callbacks write here
+    dk_input_t* snapshot; // the frame's coalesced input
+    uint64_t input_raw;   // callbacks over the whole run
+    uint64_t input_posted;
+    uint64_t input_dropped;
+    dk_replay_t replay;
+    dk_startup_t startup;
+    dk_reload_t reload;
+    const char* profile_path;
     GLFWwindow* glfw_window;
     dk_layer_t* layers;
-    dk_module_t* modules;
+    dk_module_registry_t modules;
     uint32_t layer_count;
-    uint32_t module_count;
-    uint32_t active_requests;
+    volatile uint32_t active_requests; // submitted and not yet through their completion
     bool is_running;
+    bool is_headless;
 } dk_app_t;
 
 extern int _dk_app_init(const dk_config_t* config);
@@ -38,10 +174,84 @@ extern int _dk_app_run(void);
 extern int _dk_app_shutdown(void);
 
 extern int _dk_app_status_update(void);
+extern void _dk_app_request_dispatch(void);
+extern void _dk_app_request_complete(void);
+extern void _dk_app_request_drain(void);
 extern void _dk_app_layer_update(void);
+extern void _dk_app_layer_fixed_update(void);
 extern void _dk_app_time_update(uint64_t* time);
 
+extern void _dk_app_pacer_init(dk_pacer_t* pacer, dk_pacer_mode mode, bool headless);
+extern void _dk_app_pacer_wait(dk_pacer_t* pacer, uint64_t time, uint64_t deadline);
+extern void _dk_app_pacer_record(dk_pacer_t* pacer, uint64_t deadline, uint64_t time);
+extern void _dk_app_pacer_report(const dk_pacer_t* pacer);
+
+extern void _dk_app_timestep_init(dk_timestep_t* timestep, uint32_t rate, uint64_t time);
+extern uint32_t _dk_app_timestep_advance(dk_timestep_t* timestep, uint64_t time);
+
+extern int _dk_app_layer_graph_init(dk_layer_graph_t* graph, const dk_layer_t* layers, uint32_t layer_count);
+extern void _dk_app_layer_graph_shutdown(dk_layer_graph_t* graph);
+
+extern int _dk_frame_arena_init(dk_frame_arena_t* frame, uint32_t count, uint64_t reserve, uint32_t flags);
+extern void _dk_frame_arena_begin(dk_frame_arena_t* frame);
+extern void* _dk_frame_arena_alloc(dk_frame_arena_t* frame, uint64_t size, uint64_t align);
+extern void _dk_frame_arena_report(const dk_frame_arena_t* frame);
+extern void _dk_frame_arena_shutdown(dk_frame_arena_t* frame);
+
+extern void _dk_app_stats_init(dk_stats_t* stats, uint64_t time);
+extern void _dk_app_stats_record(dk_stats_t* stats, uint64_t duration, uint64_t time);
+extern void _dk_app_stats_rotate(dk_stats_t* stats, uint64_t time);
+extern void _dk_app_stats_query(const dk_stats_t* stats, bool window, dk_frame_stats_t* out);
+extern void _dk_app_stats_report(const char* name, const dk_stats_t* stats);
+
+/* cpu time of whole frames or of one layer's on_update; window = the last complete second
+ * instead of everything since startup */
+extern int dk_app_frame_stats(dk_frame_stats_t* stats, bool window);
+extern int dk_app_layer_stats(uint32_t layer, dk_frame_stats_t* stats, bool window);
+
+/* fixed simulation step (s) and how far the current frame sits between two ticks [0, 1) */
+extern double dk_app_tick_delta(void);
+extern double dk_app_tick_alpha(void);
+
+/* Memory that lives until the same buffer comes round again, count - 1 frames after this
+ * one. Safe from any thread while a frame runs; never freed individually. */
+extern void* dk_frame_alloc(uint64_t size);
+extern void* dk_frame_alloc_aligned(uint64_t size, uint64_t align);
+extern uint64_t dk_frame_high_water(void);
+
+/* Queues a copy for every layer's on_request at the start of the next frame. Safe from any
+ * thread; false if the frame's batch is full and the request was dropped. */
+extern bool dk_request_post(const dk_request_t* request);
+
+/* pooled, safe from any thread; a request may be freed on another thread than its own */
+extern dk_request_t* dk_request_alloc(void);
+extern void dk_request_free(dk_request_t* request);
+
+/* Runs execute on a job worker, then complete on the main thread at the start of a later
+ * frame, after which the request is freed. request must come from dk_request_alloc and the
+ * payload goes in request->data. Submitted from a thread outside the job system, execute
+ * runs inline. Shutdown waits for every submitted request to complete. */
+extern int dk_request_submit(dk_request_t* request, dk_request_cb execute, dk_request_cb complete);
+extern uint32_t dk_request_active(void);
+
+/* Window input coalesced over the frame: key and button events in order, the last cursor
+ * position, summed scroll and the final framebuffer size. The same events reach on_request
+ * as one request each; valid until the next frame, main thread only. */
+extern const dk_input_t* dk_app_input(void);
+
+/* The module of that type; a DK_MODULE_FLAG_LAZY one is started on the spot, or waited for
+ * if the background start after the first frame got to it first. NULL if none is
+ * registered or it failed. */
+extern dk_module_t* dk_app_module(dk_module_type type);
+
 extern int _dk_app_window_init(dk_app_t* app, int width, int height, const char* name);
 extern void _dk_app_window_poll(void);
+extern int _dk_app_input_init(dk_app_t* app);
+extern void _dk_app_input_flush(dk_app_t* app, uint64_t time);
+extern void _dk_app_input_report(const dk_app_t* app);
+
+extern int _dk_app_reload_init(dk_app_t* app);
+extern void _dk_app_reload_check(dk_app_t* app);
+extern void _dk_app_reload_shutdown(dk_app_t* app);
 
 #endif // DEAKO_APP_H
\ No newline at end of file
@@ -0,0 +1,142 @@
+#include "deako_pch.h"
+#include "deako_app.h"
+
+#include "platform/deako_atomic.h"
+
+#include <malloc.h>
+
+#define DK_FRAME_ARENA_RESERVE (64ull * 1024 * 1024)
+
+/* header of a malloc fallback block, the payload follows at the requested alignment */
+typedef struct dk_frame_spill {
+    struct dk_frame_spill* next;
+    uint64_t size;
+} dk_frame_spill_t;
+
+int _dk_frame_arena_init(dk_frame_arena_t* frame, uint32_t count, uint64_t reserve, uint32_t flags)
+{
+    count = count ? count : 2;
+    DK_CHECK(count >= 2 && count <= DK_FRAME_ARENA_MAX, DK_ERRNO_UNKNOWN);
+
+    frame->count       = count;
+    frame->index       = 0;
+    frame->high_water  = 0;
+    frame->spill_count = 0;
+    frame->spill_bytes = 0;
+    frame->frame_count = 0;
+
+    for (uint32_t i = 0; i < DK_FRAME_ARENA_MAX; i++)
+    {
+        dk_arena_init_buffer(&frame->buffers[i], NULL, 0);
+        frame->spills[i]  = NULL;
+        frame->spilled[i] = 0;
+    }
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        int status = dk_arena_init_virtual(&frame->buffers[i], reserve ? reserve : DK_FRAME_ARENA_RESERVE, flags);
+        if (status < DK_STATUS_OK)
+        {
+            frame->count = i; // unwinds the buffers already reserved
+            _dk_frame_arena_shutdown(frame);
+            return status;
+        }
+        dk_arena_track(&frame->buffers[i], "FRAME");
+    }
+
+    return DK_STATUS_OK;
+}
+
+static void _dk_frame_arena_release(dk_frame_arena_t* frame, uint32_t index)
+{
+    uint64_t used = frame->buffers[index].offset + frame->spilled[index];
+    frame->high_water  = (used > frame->high_water) ? used : frame->high_water;
+
+    dk_frame_spill_t* spill = dk_atomic_exchange_ptr(&frame->spills[index], NULL);
+    while (spill)
+    {
+        dk_frame_spill_t* next = spill->next;
+        free(spill);
+        spill = next;
+    }
+
+    frame->spilled[index] = 0;
+    dk_arena_reset(&frame->buffers[index]);
+}
+
+/* Called on the main thread before a frame's callbacks, nothing may be allocating. The
+ * buffer being reused was last handed out count - 1 frames ago. */
+void _dk_frame_arena_begin(dk_frame_arena_t* frame)
+{
+    frame->index       = (frame->index + 1) % frame->count;
+    frame->frame_count++;
+    _dk_frame_arena_release(frame, frame->index);
+}
+
+void* _dk_frame_arena_alloc(dk_frame_arena_t* frame, uint64_t size, uint64_t align)
+{
+    uint32_t index = frame->index;
+    void* memory   = dk_arena_alloc_atomic(&frame->buffers[index], size, align);
+    if (memory)
+    {
+        return memory;
+    }
+
+    /* reservation exhausted: stay correct and let the report say how much more to reserve */
+    dk_frame_spill_t* spill = malloc(sizeof(*spill) + align - 1 + size);
+    if (!spill)
+    {
+        return NULL;
+    }
+
+    spill->size = size;
+    void* head  = dk_atomic_load_ptr(&frame->spills[index]);
+    do
+    {
+        spill->next = head;
+    } while (!dk_atomic_cas_ptr(&frame->spills[index], &head, spill));
+
+    dk_atomic_add_u64(&frame->spilled[index], size);
+    dk_atomic_add_u64(&frame->spill_count, 1);
+    dk_atomic_add_u64(&frame->spill_bytes, size);
+
+    uintptr_t payload = (uintptr_t)(spill + 1);
+    return (void*)((payload + align - 1) & ~(uintptr_t)(align - 1));
+}
+
+void _dk_frame_arena_report(const dk_frame_arena_t* frame)
+{
+    uint64_t high_water = frame->high_water;
+    for (uint32_t i = 0; i < frame->count; i++)
+    {
+        uint64_t used = dk_arena_high_water(&frame->buffers[i]) + frame->spilled[i];
+        high_water    = (used > high_water) ? used : high_water;
+    }
+
+    uint64_t committed = 0;
+    for (uint32_t i = 0; i < frame->count; i++)
+    {
+        committed += frame->buffers[i].capacity;
+    }
+
+    DK_INFO("frame arena: %u x %.1f MiB reserved, %.1f KiB committed, high water %.1f KiB over %llu frames",
+    frame->count, (double)frame->buffers[0].reserved / (1024 * 1024), (double)committed / 1024,
+    (double)high_water / 1024, (unsigned long long)frame->frame_count);
+
+    if (frame->spill_count)
+    {
+        DK_WARN("frame arena: %llu allocations (%.1f KiB) fell back to malloc, raise frame_arena_reserve",
+        (unsigned long long)frame->spill_count, (double)frame->spill_bytes / 1024);
+    }
+}
+
+void _dk_frame_arena_shutdown(dk_frame_arena_t* frame)
+{
+    for (uint32_t i = 0; i < frame->count; i++)
+    {
+        _dk_frame_arena_release(frame, i);
+        dk_arena_shutdown(&frame->buffers[i]);
+    }
+
+    frame->count       = 0;
+}
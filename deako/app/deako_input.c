@@ -0,0 +1,123 @@
+#include "deako_pch.h"
+#include "deako_input.h"
+#include "deako_app.h"
+
+void _dk_input_begin(dk_input_t* input, const dk_input_t* previous)
+{
+    input->count    = 0;
+    input->dropped  = 0;
+    input->flags    = DK_INPUT_FLAG_NONE;
+    input->raw      = 0;
+    input->cursor_x = previous ? previous->cursor_x : 0.0;
+    input->cursor_y = previous ? previous->cursor_y : 0.0;
+    input->scroll_x = 0.0;
+    input->scroll_y = 0.0;
+    input->width    = previous ? previous->width : 0;
+    input->height   = previous ? previous->height : 0;
+}
+
+void _dk_input_event(
+dk_input_t* input, dk_request_type type, int32_t code, int32_t scancode, int32_t action, int32_t mods)
+{
+    input->raw++;
+    if (input->count == DK_INPUT_CAPACITY)
+    {
+        input->dropped++;
+        return;
+    }
+
+    uint32_t i          = input->count++;
+    input->types[i]     = (uint8_t)type;
+    input->actions[i]   = (uint8_t)action;
+    input->mods[i]      = (uint8_t)mods;
+    input->codes[i]     = (int16_t)code;
+    input->scancodes[i] = scancode;
+    input->xs[i]        = (float)input->cursor_x;
+    input->ys[i]        = (float)input->cursor_y;
+}
+
+void _dk_input_cursor(dk_input_t* input, double x, double y)
+{
+    input->raw++;
+    input->cursor_x = x;
+    input->cursor_y = y;
+    input->flags |= DK_INPUT_FLAG_CURSOR;
+}
+
+void _dk_input_scroll(dk_input_t* input, double x, double y)
+{
+    input->raw++;
+    input->scroll_x += x;
+    input->scroll_y += y;
+    input->flags |= DK_INPUT_FLAG_SCROLL;
+}
+
+void _dk_input_resize(dk_input_t* input, int32_t width, int32_t height)
+{
+    input->raw++;
+    input->width  = width;
+    input->height = height;
+    input->flags |= DK_INPUT_FLAG_RESIZE;
+}
+
+void _dk_input_close(dk_input_t* input)
+{
+    input->raw++;
+    input->flags |= DK_INPUT_FLAG_CLOSE;
+}
+
+uint32_t _dk_input_post(const dk_input_t* input)
+{
+    uint32_t posted = 0;
+
+    if (input->flags & DK_INPUT_FLAG_CLOSE)
+    {
+        dk_request_t request = { .type = DK_REQUEST_TYPE_WINDOW_CLOSE };
+        posted += dk_request_post(&request);
+    }
+
+    if (input->flags & DK_INPUT_FLAG_RESIZE)
+    {
+        dk_request_t request       = { .type = DK_REQUEST_TYPE_WINDOW_RESIZE };
+        request.data.resize.width  = input->width;
+        request.data.resize.height = input->height;
+        posted += dk_request_post(&request);
+    }
+
+    for (uint32_t i = 0; i < input->count; i++)
+    {
+        dk_request_t request = { .type = (dk_request_type)input->types[i] };
+        if (request.type == DK_REQUEST_TYPE_KEY)
+        {
+            request.data.key.key      = input->codes[i];
+            request.data.key.scancode = input->scancodes[i];
+            request.data.key.action   = input->actions[i];
+            request.data.key.mods     = input->mods[i];
+        }
+        else
+        {
+            request.data.mouse_button.button = input->codes[i];
+            request.data.mouse_button.action = input->actions[i];
+            request.data.mouse_button.mods   = input->mods[i];
+        }
+        posted += dk_request_post(&request);
+    }
+
+    if (input->flags & DK_INPUT_FLAG_CURSOR)
+    {
+        dk_request_t request  = { .type = DK_REQUEST_TYPE_CURSOR };
+        request.data.cursor.x = input->cursor_x;
+        request.data.cursor.y = input->cursor_y;
+        posted += dk_request_post(&request);
+    }
+
+    if (input->flags & DK_INPUT_FLAG_SCROLL)
+    {
+        dk_request_t request  = { .type = DK_REQUEST_TYPE_SCROLL };
+        request.data.scroll.x = input->scroll_x;
+        request.data.scroll.y = input->scroll_y;
+        posted += dk_request_post(&request);
+    }
+
+    return posted;
+}
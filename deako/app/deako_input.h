@@ -0,0 +1,55 @@
+#ifndef DEAKO_INPUT_H
+#define DEAKO_INPUT_H
+
+#include "deako_internal.h"
+
+#include <stdint.h>
+
+#define DK_INPUT_CAPACITY 256 // key and button events per frame, more are counted and dropped
+
+typedef enum dk_input_flag {
+    DK_INPUT_FLAG_NONE   = 0,
+    DK_INPUT_FLAG_CURSOR = 1 << 0,
+    DK_INPUT_FLAG_SCROLL = 1 << 1,
+    DK_INPUT_FLAG_RESIZE = 1 << 2,
+    DK_INPUT_FLAG_CLOSE  = 1 << 3,
+} dk_input_flag;
+
+/* One frame of window input. Key and button events keep their order, one column per field;
+ * cursor moves, scrolls and resizes only keep their net effect, so a 1000 Hz mouse costs
+ * one request per frame instead of one per report. */
+typedef struct dk_input {
+    uint8_t types[DK_INPUT_CAPACITY]; // DK_REQUEST_TYPE_KEY or DK_REQUEST_TYPE_MOUSE_BUTTON
+    uint8_t actions[DK_INPUT_CAPACITY];
+    uint8_t mods[DK_INPUT_CAPACITY];
+    int16_t codes[DK_INPUT_CAPACITY]; // key or button
+    int32_t scancodes[DK_INPUT_CAPACITY];
+    float xs[DK_INPUT_CAPACITY]; // cursor when the event arrived
+    float ys[DK_INPUT_CAPACITY];
+    uint32_t count;
+    uint32_t dropped;
+    uint32_t flags;  // dk_input_flag, what changed this frame
+    uint32_t raw;    // callbacks received this frame, before coalescing
+    double cursor_x; // last position, carried over between frames
+    double cursor_y;
+    double scroll_x; // summed over the frame
+    double scroll_y;
+    int32_t width; // last framebuffer size, carried over between frames
+    int32_t height;
+} dk_input_t;
+
+/* starts capturing into input, carrying cursor and size over from previous */
+extern void _dk_input_begin(dk_input_t* input, const dk_input_t* previous);
+
+extern void _dk_input_event(
+dk_input_t* input, dk_request_type type, int32_t code, int32_t scancode, int32_t action, int32_t mods);
+extern void _dk_input_cursor(dk_input_t* input, double x, double y);
+extern void _dk_input_scroll(dk_input_t* input, double x, double y);
+extern void _dk_input_resize(dk_input_t* input, int32_t width, int32_t height);
+extern void _dk_input_close(dk_input_t* input);
+
+/* posts the frame as requests: close, resize, the events in order, then one cursor and one
+ * scroll; returns how many */
+extern uint32_t _dk_input_post(const dk_input_t* input);
+
+#endif // DEAKO_INPUT_H
@@ -0,0 +1,84 @@
+#include "deako_pch.h"
+#include "deako_app.h"
+
+#include <malloc.h>
+
+static bool _dk_layer_conflict(const dk_layer_t* a, const dk_layer_t* b)
+{
+    if (!(a->reads | a->writes) || !(b->reads | b->writes))
+    {
+        return true;
+    }
+
+    return (a->writes & (b->reads | b->writes)) || (b->writes & a->reads);
+}
+
+/* Each layer lands in the wave after the latest earlier layer it conflicts with, so
+ * declaration order is kept wherever it matters. O(n^2), done once at init. */
+int _dk_app_layer_graph_init(dk_layer_graph_t* graph, const dk_layer_t* layers, uint32_t layer_count)
+{
+    graph->order      = NULL;
+    graph->waves      = NULL;
+    graph->wave_count = 0;
+    graph->decls      = NULL;
+
+    if (layer_count == 0)
+    {
+        return DK_STATUS_OK;
+    }
+
+    uint32_t* wave = malloc(layer_count * sizeof(*wave));
+    graph->order   = malloc(layer_count * sizeof(*graph->order));
+    graph->waves   = malloc((layer_count + 1) * sizeof(*graph->waves));
+    graph->decls   = malloc(layer_count * sizeof(*graph->decls));
+    if (!wave || !graph->order || !graph->waves || !graph->decls)
+    {
+        free(wave);
+        _dk_app_layer_graph_shutdown(graph);
+        DK_ERROR_HANDLE(DK_ERRNO_UNKNOWN);
+    }
+
+    for (uint32_t j = 0; j < layer_count; j++)
+    {
+        wave[j] = 0;
+        for (uint32_t i = 0; i < j; i++)
+        {
+            if (wave[i] + 1 > wave[j] && _dk_layer_conflict(&layers[i], &layers[j]))
+            {
+                wave[j] = wave[i] + 1;
+            }
+        }
+        graph->wave_count = (wave[j] + 1 > graph->wave_count) ? wave[j] + 1 : graph->wave_count;
+    }
+
+    uint32_t count = 0;
+    for (uint32_t w = 0; w < graph->wave_count; w++)
+    {
+        graph->waves[w] = count;
+        for (uint32_t i = 0; i < layer_count; i++)
+        {
+            if (wave[i] == w)
+            {
+                graph->order[count++] = i;
+            }
+        }
+    }
+    graph->waves[graph->wave_count] = count;
+
+    free(wave);
+
+    DK_DEBUG("layer graph: %u layers in %u waves", layer_count, graph->wave_count);
+
+    return DK_STATUS_OK;
+}
+
+void _dk_app_layer_graph_shutdown(dk_layer_graph_t* graph)
+{
+    free(graph->order);
+    free(graph->waves);
+    free(graph->decls);
+    graph->order      = NULL;
+    graph->waves      = NULL;
+    graph->decls      = NULL;
+    graph->wave_count = 0;
+}
@@ -0,0 +1,66 @@
+#include "deako_pch.h"
+#include "deako_app.h"
+
+#include <GLFW/glfw3.h>
+
+#define DK_PACER_SPIN_THRESHOLD DK_NS_PER_MS // tail of the interval that is busy-waited in hybrid mode
+
+void _dk_app_pacer_init(dk_pacer_t* pacer, dk_pacer_mode mode, bool headless)
+{
+    pacer->mode           = mode;
+    pacer->headless       = headless;
+    pacer->spin_threshold = (mode == DK_PACER_MODE_HYBRID) ? DK_PACER_SPIN_THRESHOLD : 0;
+    pacer->frame_count    = 0;
+    pacer->jitter_sum     = 0;
+    pacer->jitter_max     = 0;
+}
+
+/* Blocks for at most one step from time towards deadline (ns). The caller re-polls and
+ * re-checks the timer after every return, so waking early on window events is harmless. */
+void _dk_app_pacer_wait(dk_pacer_t* pacer, uint64_t time, uint64_t deadline)
+{
+    if (pacer->mode == DK_PACER_MODE_SPIN || pacer->mode == DK_PACER_MODE_UNCAPPED)
+    {
+        return;
+    }
+
+    if (time + pacer->spin_threshold >= deadline)
+    {
+        return;
+    }
+
+    if (pacer->headless)
+    {
+        dk_clock_sleep_ns(deadline - time - pacer->spin_threshold);
+    }
+    else
+    {
+        glfwWaitEventsTimeout((double)(deadline - time - pacer->spin_threshold) / (double)DK_NS_PER_S);
+    }
+}
+
+void _dk_app_pacer_record(dk_pacer_t* pacer, uint64_t deadline, uint64_t time)
+{
+    uint64_t lateness = (time > deadline) ? time - deadline : 0;
+
+    pacer->frame_count++;
+    pacer->jitter_sum += lateness;
+    if (lateness > pacer->jitter_max)
+    {
+        pacer->jitter_max = lateness;
+    }
+}
+
+void _dk_app_pacer_report(const dk_pacer_t* pacer)
+{
+    static const char* mode_names[] = { "hybrid", "sleep", "spin", "uncapped" };
+
+    if (pacer->frame_count == 0)
+    {
+        return;
+    }
+
+    DK_INFO("pacer (%s): %llu frames, jitter mean %.3f ms, max %.3f ms", mode_names[pacer->mode],
+    (unsigned long long)pacer->frame_count, (double)pacer->jitter_sum / (double)pacer->frame_count / DK_NS_PER_MS,
+    (double)pacer->jitter_max / DK_NS_PER_MS);
+}
@@ -0,0 +1,306 @@
+#include "deako_pch.h"
+#include "deako_app.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define DK_RELOAD_PATH_MAX 512
+
+/* dlopen hands back the already loaded image for a path it has seen, so every version is
+ * loaded from its own copy; the build is also free to overwrite the original meanwhile */
+static dk_library_t _dk_reload_open(const dk_reload_library_t* library, uint32_t version)
+{
+    char copy[DK_RELOAD_PATH_MAX];
+    snprintf(copy, sizeof(copy), "%s.reload%u", library->path, version);
+
+    if (!dk_file_copy(library->path, copy))
+    {
+        DK_ERROR("reload: cannot copy %s to %s", library->path, copy);
+        remove(copy);
+        return NULL;
+    }
+
+    dk_library_t handle = dk_library_open(copy);
+    remove(copy); // the mapping outlives the file, windows refuses until closed
+    return handle;
+}
+
+static void _dk_reload_close(const dk_reload_library_t* library, dk_library_t handle, uint32_t version)
+{
+    char copy[DK_RELOAD_PATH_MAX];
+    snprintf(copy, sizeof(copy), "%s.reload%u", library->path, version);
+
+    dk_library_close(handle);
+    remove(copy);
+}
+
+/* ISO C has no cast between object and function pointers, the bytes are copied instead */
+static void _dk_reload_symbol(dk_library_t handle, const char* name, void* function, size_t size)
+{
+    void* symbol = dk_library_symbol(handle, name);
+    memcpy(function, &symbol, size);
+}
+
+/* layers [0, end) bound to the library */
+static void _dk_reload_unload(dk_app_t* app, uint32_t index, dk_library_t handle, uint32_t end)
+{
+    dk_plugin_unload_cb unload;
+    _dk_reload_symbol(handle, DK_PLUGIN_UNLOAD, &unload, sizeof(unload));
+    if (!unload)
+    {
+        return;
+    }
+
+    for (uint32_t i = 0; i < end; i++)
+    {
+        if (app->reload.layer_library[i] == index)
+        {
+            unload(app->layers[i].name, &app->reload.states[i]);
+        }
+    }
+}
+
+/* Asks the library for the callbacks of every layer bound to it and only assigns them once
+ * all of them loaded; on failure the layers that did load are unloaded again. On a reload
+ * the bus is rebound as well, it was built from the old pointers. */
+static int _dk_reload_bind(dk_app_t* app, uint32_t index, dk_library_t handle, bool reload)
+{
+    const dk_reload_library_t* library = &app->reload.libraries[index];
+
+    dk_plugin_load_cb load;
+    _dk_reload_symbol(handle, DK_PLUGIN_LOAD, &load, sizeof(load));
+    if (!load)
+    {
+        DK_ERROR("reload: %s does not export %s", library->path, DK_PLUGIN_LOAD);
+        return DK_ERRNO_UNKNOWN;
+    }
+
+    dk_scratch_t scratch = dk_scratch_begin(NULL);
+    dk_plugin_t* plugins = dk_scratch_alloc(&scratch, (app->layer_count ? app->layer_count : 1) * sizeof(*plugins), 8);
+    int status           = plugins ? DK_STATUS_OK : DK_ERRNO_UNKNOWN;
+    uint32_t loaded      = 0; // layers before this one finished their load
+
+    for (uint32_t i = 0; status == DK_STATUS_OK && i < app->layer_count; i++)
+    {
+        if (app->reload.layer_library[i] != index)
+        {
+            continue;
+        }
+
+        memset(&plugins[i], 0, sizeof(plugins[i]));
+        status = load(app->layers[i].name, &plugins[i], &app->reload.states[i], reload);
+        if (status != DK_STATUS_OK)
+        {
+            DK_ERROR("reload: %s rejected layer %s (%d)", library->path, app->layers[i].name, status);
+            break;
+        }
+
+        loaded = i + 1;
+        if (reload && !app->layers[i].on_request != !plugins[i].on_request)
+        {
+            /* the bus has no slot for a subscriber that appears or disappears */
+            DK_ERROR("reload: layer %s cannot gain or lose on_request without a restart", app->layers[i].name);
+            status = DK_ERRNO_UNKNOWN;
+        }
+    }
+
+    if (status != DK_STATUS_OK)
+    {
+        _dk_reload_unload(app, index, handle, loaded);
+    }
+
+    for (uint32_t i = 0; status == DK_STATUS_OK && i < app->layer_count; i++)
+    {
+        if (app->reload.layer_library[i] != index)
+        {
+            continue;
+        }
+
+        if (reload)
+        {
+            _dk_bus_rebind(&app->bus, i, plugins[i].on_request); // bus subscribers are the layers, in order
+        }
+        app->layers[i].on_update       = plugins[i].on_update;
+        app->layers[i].on_request      = plugins[i].on_request;
+        app->layers[i].on_fixed_update = plugins[i].on_fixed_update;
+    }
+
+    dk_scratch_end(&scratch);
+    return status;
+}
+
+/* Between frames: nothing runs the old code once the submitted requests have drained. A
+ * version that fails to load or bind is dropped and the old one rebound, state included. */
+static void _dk_reload_swap(dk_app_t* app, uint32_t index, uint64_t mtime)
+{
+    dk_reload_t* reload          = &app->reload;
+    dk_reload_library_t* library = &reload->libraries[index];
+    library->mtime               = mtime; // a broken build is not retried until it changes again
+
+    _dk_app_request_drain();
+
+    uint64_t begin      = dk_clock_now_ns();
+    dk_library_t handle = _dk_reload_open(library, library->version + 1);
+    if (!handle)
+    {
+        reload->failures++;
+        return;
+    }
+
+    _dk_reload_unload(app, index, library->library, app->layer_count);
+    int status = _dk_reload_bind(app, index, handle, true);
+    if (status != DK_STATUS_OK)
+    {
+        _dk_reload_close(library, handle, library->version + 1); // bind unloaded what it loaded
+
+        status = _dk_reload_bind(app, index, library->library, true);
+        if (status != DK_STATUS_OK)
+        {
+            DK_ERROR("reload: %s could not be rebound either", library->path);
+        }
+        reload->failures++;
+        return;
+    }
+
+    _dk_reload_close(library, library->library, library->version);
+    library->library = handle;
+    library->version++;
+    reload->reloads++;
+
+    DK_INFO("reload: %s version %u in %.3f ms", library->path, library->version,
+    (double)(dk_clock_now_ns() - begin) / DK_NS_PER_MS);
+}
+
+void* dk_plugin_state(dk_arena_t* state, uint64_t size)
+{
+    if (state->offset == 0)
+    {
+        void* data = dk_arena_alloc(state, size, DK_ARENA_ALIGN);
+        if (data)
+        {
+            memset(data, 0, size);
+        }
+        return data;
+    }
+
+    return (size <= state->offset) ? state->base : NULL;
+}
+
+int _dk_app_reload_init(dk_app_t* app)
+{
+    dk_reload_t* reload = &app->reload;
+    memset(reload, 0, sizeof(*reload));
+
+    uint32_t count        = app->layer_count ? app->layer_count : 1;
+    reload->layer_library = dk_arena_alloc(&app->arena, count * sizeof(*reload->layer_library), 8);
+    reload->states        = dk_arena_alloc(&app->arena, count * sizeof(*reload->states), 8);
+    DK_CHECK(reload->layer_library && reload->states, DK_ERRNO_UNKNOWN);
+    memset(reload->states, 0, count * sizeof(*reload->states));
+
+    for (uint32_t i = 0; i < app->layer_count; i++)
+    {
+        reload->layer_library[i] = DK_RELOAD_NONE;
+
+        const char* path = app->layers[i].library;
+        if (!path)
+        {
+            continue;
+        }
+
+        uint32_t index = 0;
+        while (index < reload->library_count && strcmp(reload->libraries[index].path, path) != 0)
+        {
+            index++;
+        }
+
+        if (index == reload->library_count)
+        {
+            DK_CHECK(index < DK_RELOAD_LIBRARIES, DK_ERRNO_UNKNOWN);
+
+            dk_reload_library_t* library = &reload->libraries[index];
+            library->path                = path;
+            library->mtime               = dk_file_mtime(path);
+            library->version             = 1;
+            library->library             = _dk_reload_open(library, library->version);
+            DK_CHECK(library->library, DK_ERRNO_UNKNOWN);
+            reload->library_count++;
+        }
+
+        reload->layer_library[i] = index;
+
+        int status = dk_arena_init_virtual(&reload->states[i], DK_RELOAD_STATE_RESERVE, DK_ARENA_FLAG_NONE);
+        DK_STATUS(status);
+        dk_arena_track(&reload->states[i], app->layers[i].name);
+    }
+
+    for (uint32_t index = 0; index < reload->library_count; index++)
+    {
+        int status = _dk_reload_bind(app, index, reload->libraries[index].library, false);
+        DK_STATUS(status);
+    }
+
+    return DK_STATUS_OK;
+}
+
+/* A library is reloaded once a changed mtime holds still for a whole poll, so a linker
+ * still writing it is not caught halfway. */
+void _dk_app_reload_check(dk_app_t* app)
+{
+    dk_reload_t* reload = &app->reload;
+
+    for (uint32_t index = 0; index < reload->library_count; index++)
+    {
+        dk_reload_library_t* library = &reload->libraries[index];
+
+        uint64_t mtime = dk_file_mtime(library->path);
+        if (mtime == 0 || mtime == library->mtime)
+        {
+            library->pending = 0;
+            continue;
+        }
+
+        if (mtime != library->pending)
+        {
+            library->pending = mtime;
+            continue;
+        }
+
+        library->pending = 0;
+        _dk_reload_swap(app, index, mtime);
+    }
+}
+
+void _dk_app_reload_shutdown(dk_app_t* app)
+{
+    dk_reload_t* reload = &app->reload;
+    if (reload->library_count == 0)
+    {
+        return;
+    }
+
+    _dk_timer_wheel_cancel(&app->timers, reload->timer);
+
+    for (uint32_t index = 0; index < reload->library_count; index++)
+    {
+        dk_reload_library_t* library = &reload->libraries[index];
+        _dk_reload_unload(app, index, library->library, app->layer_count);
+        _dk_reload_close(library, library->library, library->version);
+        library->library = NULL;
+    }
+
+    for (uint32_t i = 0; i < app->layer_count; i++)
+    {
+        if (reload->layer_library[i] == DK_RELOAD_NONE)
+        {
+            continue;
+        }
+
+        app->layers[i].on_update       = NULL;
+        app->layers[i].on_request      = NULL;
+        app->layers[i].on_fixed_update = NULL;
+        dk_arena_shutdown(&reload->states[i]);
+    }
+
+    DK_INFO("reload: %u libraries, %llu reloads, %llu failures", reload->library_count,
+    (unsigned long long)reload->reloads, (unsigned long long)reload->failures);
+}
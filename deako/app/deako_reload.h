@@ -0,0 +1,60 @@
+#ifndef DEAKO_RELOAD_H
+#define DEAKO_RELOAD_H
+
+#include "deako_internal.h"
+#include "platform/deako_library.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define DK_RELOAD_LIBRARIES     8
+#define DK_RELOAD_NONE          UINT32_MAX
+#define DK_RELOAD_POLL          (250ull * DK_NS_PER_MS)    // how often the libraries are checked
+#define DK_RELOAD_STATE_RESERVE (64ull * 1024 * 1024)      // per reloadable layer
+
+#define DK_PLUGIN_LOAD   "dk_plugin_load"
+#define DK_PLUGIN_UNLOAD "dk_plugin_unload"
+
+/* The callbacks a library hands back for one of its layers. */
+typedef struct dk_plugin {
+    dk_on_update_cb on_update;
+    dk_on_request_cb on_request;
+    dk_on_update_cb on_fixed_update;
+} dk_plugin_t;
+
+/* Exported by a layer library as dk_plugin_load: fill plugin for the named layer. state
+ * outlives every version of the library, keep anything that has to survive a reload in it
+ * (dk_plugin_state) rather than in globals. Return DK_STATUS_OK or the reload is rejected
+ * and the previous version stays bound. */
+typedef int (*dk_plugin_load_cb)(const char* layer, dk_plugin_t* plugin, dk_arena_t* state, bool reload);
+
+/* Optional dk_plugin_unload, called on the old version before a reload and at shutdown.
+ * Cancel timers and finish anything that would call back into the library. */
+typedef void (*dk_plugin_unload_cb)(const char* layer, dk_arena_t* state);
+
+typedef struct dk_reload_library {
+    const char* path;
+    dk_library_t library;
+    uint64_t mtime;   // of the loaded version
+    uint64_t pending; // changed mtime seen on the last poll, reloaded once it holds still
+    uint32_t version;
+} dk_reload_library_t;
+
+/* Layers whose dk_layer_t.library is set take their callbacks from that shared library and
+ * get them rebound between frames when it is rebuilt. Each library is loaded from a
+ * versioned copy so the build can overwrite the original while it is in use. */
+typedef struct dk_reload {
+    dk_reload_library_t libraries[DK_RELOAD_LIBRARIES];
+    uint32_t library_count;
+    uint32_t* layer_library; // per layer, DK_RELOAD_NONE when statically linked
+    dk_arena_t* states;      // per layer, reserved for reloadable layers only
+    uint64_t timer;          // dk_timer_handle_t of the poll
+    uint64_t reloads;
+    uint64_t failures;
+} dk_reload_t;
+
+/* State for a plugin: the first size bytes of the arena, zeroed the first time, the same
+ * memory after every reload. */
+extern void* dk_plugin_state(dk_arena_t* state, uint64_t size);
+
+#endif // DEAKO_RELOAD_H
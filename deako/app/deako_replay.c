@@ -0,0 +1,200 @@
+#include "deako_pch.h"
+#include "deako_replay.h"
+
+#include <string.h>
+
+static bool _dk_replay_read(dk_replay_t* replay, void* data, size_t size)
+{
+    return fread(data, size, 1, replay->file) == 1;
+}
+
+static void _dk_replay_read_next(dk_replay_t* replay)
+{
+    replay->has_next = _dk_replay_read(replay, &replay->next, sizeof(replay->next));
+}
+
+int _dk_replay_open(dk_replay_t* replay, dk_replay_mode mode, const char* path, uint64_t timestep, uint32_t tick_rate)
+{
+    memset(replay, 0, sizeof(*replay));
+    DK_CHECK(path && mode != DK_REPLAY_MODE_NONE, DK_ERRNO_UNKNOWN);
+
+    replay->file = fopen(path, mode == DK_REPLAY_MODE_RECORD ? "wb" : "rb");
+    DK_CHECK(replay->file, DK_ERRNO_UNKNOWN);
+    replay->mode = mode;
+
+    if (mode == DK_REPLAY_MODE_RECORD)
+    {
+        replay->header.magic     = DK_REPLAY_MAGIC;
+        replay->header.version   = DK_REPLAY_VERSION;
+        replay->header.timestep  = timestep;
+        replay->header.tick_rate = tick_rate;
+        DK_CHECK(fwrite(&replay->header, sizeof(replay->header), 1, replay->file) == 1, DK_ERRNO_UNKNOWN);
+    }
+    else
+    {
+        DK_CHECK(_dk_replay_read(replay, &replay->header, sizeof(replay->header)), DK_ERRNO_UNKNOWN);
+        DK_CHECK(replay->header.magic == DK_REPLAY_MAGIC, DK_ERRNO_UNKNOWN);
+        DK_CHECK(replay->header.version == DK_REPLAY_VERSION, DK_ERRNO_UNKNOWN);
+        _dk_replay_read_next(replay);
+    }
+
+    return DK_STATUS_OK;
+}
+
+void _dk_replay_close(dk_replay_t* replay)
+{
+    if (!replay->file)
+    {
+        return;
+    }
+
+    if (replay->mode == DK_REPLAY_MODE_RECORD)
+    {
+        DK_INFO("replay: recorded %llu frames, %llu events", (unsigned long long)replay->frames,
+        (unsigned long long)replay->events);
+    }
+    else
+    {
+        DK_INFO("replay: played %llu frames, %llu events, %llu skipped", (unsigned long long)replay->frames,
+        (unsigned long long)replay->events, (unsigned long long)replay->skipped);
+    }
+
+    fclose(replay->file);
+    replay->file = NULL;
+}
+
+void _dk_replay_record(dk_replay_t* replay, uint64_t frame, uint64_t time, const dk_input_t* input)
+{
+    dk_replay_frame_t header = {
+        .frame = frame,
+        .time  = time,
+        .flags = input->flags & ~DK_INPUT_FLAG_CLOSE, // replays end with the recording instead
+        .count = input->count,
+    };
+    fwrite(&header, sizeof(header), 1, replay->file);
+
+    if (header.flags & DK_INPUT_FLAG_CURSOR)
+    {
+        double cursor[2] = { input->cursor_x, input->cursor_y };
+        fwrite(cursor, sizeof(cursor), 1, replay->file);
+    }
+    if (header.flags & DK_INPUT_FLAG_SCROLL)
+    {
+        double scroll[2] = { input->scroll_x, input->scroll_y };
+        fwrite(scroll, sizeof(scroll), 1, replay->file);
+    }
+    if (header.flags & DK_INPUT_FLAG_RESIZE)
+    {
+        int32_t size[2] = { input->width, input->height };
+        fwrite(size, sizeof(size), 1, replay->file);
+    }
+
+    for (uint32_t i = 0; i < input->count; i++)
+    {
+        dk_replay_event_t event = {
+            .type     = input->types[i],
+            .action   = input->actions[i],
+            .mods     = input->mods[i],
+            .code     = input->codes[i],
+            .scancode = input->scancodes[i],
+            .x        = input->xs[i],
+            .y        = input->ys[i],
+        };
+        fwrite(&event, sizeof(event), 1, replay->file);
+    }
+
+    replay->frames++;
+    replay->events += input->count;
+}
+
+/* skips a frame's payload without decoding it */
+static bool _dk_replay_skip(dk_replay_t* replay)
+{
+    long size = (long)replay->next.count * (long)sizeof(dk_replay_event_t);
+    size += (replay->next.flags & DK_INPUT_FLAG_CURSOR) ? 2 * sizeof(double) : 0;
+    size += (replay->next.flags & DK_INPUT_FLAG_SCROLL) ? 2 * sizeof(double) : 0;
+    size += (replay->next.flags & DK_INPUT_FLAG_RESIZE) ? 2 * sizeof(int32_t) : 0;
+    return fseek(replay->file, size, SEEK_CUR) == 0;
+}
+
+bool _dk_replay_play(dk_replay_t* replay, uint64_t frame, dk_input_t* input)
+{
+    while (replay->has_next && replay->next.frame < frame)
+    {
+        replay->skipped++;
+        replay->has_next = _dk_replay_skip(replay);
+        if (replay->has_next)
+        {
+            _dk_replay_read_next(replay);
+        }
+    }
+
+    if (!replay->has_next || replay->next.frame != frame)
+    {
+        return replay->has_next;
+    }
+
+    const dk_replay_frame_t* header = &replay->next;
+    bool ok                         = true;
+    if (header->flags & DK_INPUT_FLAG_CURSOR)
+    {
+        double cursor[2];
+        ok = ok && _dk_replay_read(replay, cursor, sizeof(cursor));
+        if (ok)
+        {
+            _dk_input_cursor(input, cursor[0], cursor[1]);
+        }
+    }
+    if (header->flags & DK_INPUT_FLAG_SCROLL)
+    {
+        double scroll[2];
+        ok = ok && _dk_replay_read(replay, scroll, sizeof(scroll));
+        if (ok)
+        {
+            _dk_input_scroll(input, scroll[0], scroll[1]);
+        }
+    }
+    if (header->flags & DK_INPUT_FLAG_RESIZE)
+    {
+        int32_t size[2];
+        ok = ok && _dk_replay_read(replay, size, sizeof(size));
+        if (ok)
+        {
+            _dk_input_resize(input, size[0], size[1]);
+        }
+    }
+
+    for (uint32_t i = 0; ok && i < header->count; i++)
+    {
+        dk_replay_event_t event;
+        ok = _dk_replay_read(replay, &event, sizeof(event));
+        /* the only types the window callbacks record, anything else is corruption */
+        ok = ok && (event.type == DK_REQUEST_TYPE_KEY || event.type == DK_REQUEST_TYPE_MOUSE_BUTTON);
+        if (ok)
+        {
+            /* the cursor goes back to where the event happened so the column matches */
+            double x        = input->cursor_x;
+            double y        = input->cursor_y;
+            input->cursor_x = event.x;
+            input->cursor_y = event.y;
+            _dk_input_event(input, (dk_request_type)event.type, event.code, event.scancode, event.action, event.mods);
+            input->cursor_x = x;
+            input->cursor_y = y;
+        }
+    }
+
+    replay->frames++;
+    replay->events += header->count;
+
+    if (ok)
+    {
+        _dk_replay_read_next(replay);
+    }
+    else
+    {
+        DK_WARN("replay: truncated or corrupt at frame %llu", (unsigned long long)frame);
+        replay->has_next = false;
+    }
+
+    return replay->has_next;
+}
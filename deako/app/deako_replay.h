@@ -0,0 +1,71 @@
+#ifndef DEAKO_REPLAY_H
+#define DEAKO_REPLAY_H
+
+#include "deako_input.h"
+#include "deako_internal.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#define DK_REPLAY_MAGIC   0x50524b44 // "DKRP"
+#define DK_REPLAY_VERSION 1
+
+typedef enum dk_replay_mode {
+    DK_REPLAY_MODE_NONE = 0,
+    DK_REPLAY_MODE_RECORD,
+    DK_REPLAY_MODE_PLAY,
+} dk_replay_mode;
+
+/* File layout: a dk_replay_header_t, then one dk_replay_frame_t per frame followed by its
+ * cursor (2 doubles), scroll (2 doubles) and size (2 int32) when flagged, then count
+ * dk_replay_event_t. Native byte order. */
+typedef struct dk_replay_header {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t timestep; // ns per frame when recorded
+    uint32_t tick_rate;
+    uint32_t reserved;
+} dk_replay_header_t;
+
+typedef struct dk_replay_frame {
+    uint64_t frame;
+    uint64_t time;  // ns since the app started
+    uint32_t flags; // dk_input_flag
+    uint32_t count; // key and button events
+} dk_replay_frame_t;
+
+typedef struct dk_replay_event {
+    uint8_t type;
+    uint8_t action;
+    uint8_t mods;
+    uint8_t reserved;
+    int16_t code;
+    int16_t reserved2;
+    int32_t scancode;
+    float x;
+    float y;
+} dk_replay_event_t;
+
+typedef struct dk_replay {
+    FILE* file;
+    dk_replay_mode mode;
+    dk_replay_header_t header;
+    dk_replay_frame_t next; // PLAY: read ahead, its time drives the clock
+    bool has_next;
+    uint64_t frames;
+    uint64_t events;
+    uint64_t skipped; // PLAY: recorded frames the replay never reached in time
+} dk_replay_t;
+
+/* RECORD writes the header from timestep and tick_rate; PLAY reads it back and the first frame */
+extern int _dk_replay_open(dk_replay_t* replay, dk_replay_mode mode, const char* path, uint64_t timestep, uint32_t tick_rate);
+extern void _dk_replay_close(dk_replay_t* replay);
+
+extern void _dk_replay_record(dk_replay_t* replay, uint64_t frame, uint64_t time, const dk_input_t* input);
+
+/* Fills input with the recorded frame if it is the next one; false once the recording is
+ * exhausted. */
+extern bool _dk_replay_play(dk_replay_t* replay, uint64_t frame, dk_input_t* input);
+
+#endif // DEAKO_REPLAY_H
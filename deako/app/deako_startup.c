@@ -0,0 +1,98 @@
+#include "deako_pch.h"
+#include "deako_startup.h"
+
+#include <stdio.h>
+
+static double _dk_startup_ms(uint64_t duration)
+{
+    return (double)duration / DK_NS_PER_MS;
+}
+
+static const char* _dk_startup_state(uint32_t state)
+{
+    switch ((dk_module_state)state)
+    {
+    case DK_MODULE_STATE_REGISTERED: return "registered";
+    case DK_MODULE_STATE_DEFERRED: return "deferred";
+    case DK_MODULE_STATE_STARTING: return "starting";
+    case DK_MODULE_STATE_READY: return "ready";
+    case DK_MODULE_STATE_FAILED: return "failed";
+    }
+    return "unknown";
+}
+
+/* same escaping as the profiler's trace, module names come from the app */
+static void _dk_startup_write_string(FILE* file, const char* string)
+{
+    fputc('"', file);
+    for (; *string; string++)
+    {
+        if (*string == '"' || *string == '\\')
+        {
+            fputc('\\', file);
+        }
+        fputc((unsigned char)*string < 0x20 ? ' ' : *string, file);
+    }
+    fputc('"', file);
+}
+
+void _dk_startup_begin(dk_startup_t* startup, const char* path)
+{
+    startup->path  = path;
+    startup->begin = dk_clock_now_ns();
+    startup->count = 0;
+}
+
+void _dk_startup_mark(dk_startup_t* startup, const char* name)
+{
+    if (startup->count < DK_STARTUP_PHASES)
+    {
+        startup->phases[startup->count].name = name;
+        startup->phases[startup->count].end  = dk_clock_now_ns();
+        startup->count++;
+    }
+}
+
+int _dk_startup_write(const dk_startup_t* startup, const dk_module_registry_t* modules)
+{
+    uint64_t end = startup->count ? startup->phases[startup->count - 1].end : startup->begin;
+    DK_INFO("startup: %.3f ms to first frame", _dk_startup_ms(end - startup->begin));
+
+    if (!startup->path)
+    {
+        return DK_STATUS_OK;
+    }
+
+    FILE* file = fopen(startup->path, "w");
+    DK_CHECK(file, DK_ERRNO_UNKNOWN);
+
+    fprintf(file, "{\n  \"time_to_first_frame_ms\": %.3f,\n  \"phases\": [", _dk_startup_ms(end - startup->begin));
+    uint64_t previous = startup->begin;
+    for (uint32_t i = 0; i < startup->count; i++)
+    {
+        const dk_startup_phase_t* phase = &startup->phases[i];
+        fprintf(file, "%s\n    { \"name\": ", i ? "," : "");
+        _dk_startup_write_string(file, phase->name);
+        fprintf(file, ", \"begin_ms\": %.3f, \"ms\": %.3f }", _dk_startup_ms(previous - startup->begin),
+        _dk_startup_ms(phase->end - previous));
+        previous = phase->end;
+    }
+
+    fprintf(file, "\n  ],\n  \"modules\": [");
+    for (uint32_t i = 0; i < modules->count; i++)
+    {
+        const dk_module_entry_t* entry = &modules->entries[i];
+        uint32_t state                 = entry->state;
+        uint64_t begin                 = (state >= DK_MODULE_STATE_READY) ? entry->init_begin - startup->begin : 0;
+        uint64_t duration              = (state >= DK_MODULE_STATE_READY) ? entry->init_time : 0;
+        fprintf(file, "%s\n    { \"name\": ", i ? "," : "");
+        _dk_startup_write_string(file, entry->module->name ? entry->module->name : "MODULE");
+        fprintf(file, ", \"wave\": %u, \"lazy\": %s, \"state\": \"%s\", \"begin_ms\": %.3f, \"ms\": %.3f }",
+        entry->wave, (entry->module->flags & DK_MODULE_FLAG_LAZY) ? "true" : "false", _dk_startup_state(state),
+        _dk_startup_ms(begin), _dk_startup_ms(duration));
+    }
+    fprintf(file, "\n  ]\n}\n");
+
+    fclose(file);
+    return DK_STATUS_OK;
+}
@@ -0,0 +1,34 @@
+#ifndef DEAKO_STARTUP_H
+#define DEAKO_STARTUP_H
+
+#include "deako_internal.h"
+#include "deako_module.h"
+
+#include <stdint.h>
+
+#define DK_STARTUP_PHASES 16
+
+typedef struct dk_startup_phase {
+    const char* name;
+    uint64_t end; // ns, a phase starts where the previous one ended
+} dk_startup_phase_t;
+
+/* Wall time from _dk_app_init to the end of the first frame, split into back to back
+ * phases, for tracking time-to-first-frame regressions. */
+typedef struct dk_startup {
+    const char* path; // trace file, NULL = log only
+    uint64_t begin;   // ns
+    dk_startup_phase_t phases[DK_STARTUP_PHASES];
+    uint32_t count;
+} dk_startup_t;
+
+extern void _dk_startup_begin(dk_startup_t* startup, const char* path);
+
+/* ends the phase called name, the next one starts now */
+extern void _dk_startup_mark(dk_startup_t* startup, const char* name);
+
+/* Logs the total and writes the trace as JSON: the phases, then every module with its wave,
+ * state and init time relative to the start. */
+extern int _dk_startup_write(const dk_startup_t* startup, const dk_module_registry_t* modules);
+
+#endif // DEAKO_STARTUP_H
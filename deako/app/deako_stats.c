@@ -0,0 +1,68 @@
+#include "deako_pch.h"
+#include "deako_app.h"
+
+#define DK_STATS_WINDOW DK_NS_PER_S
+
+void _dk_app_stats_init(dk_stats_t* stats, uint64_t time)
+{
+    _dk_histogram_reset(&stats->total);
+    _dk_histogram_reset(&stats->window);
+    _dk_histogram_reset(&stats->previous);
+    stats->window_start = time;
+}
+
+/* A window that ended more than a window ago saw nothing, it must not linger as the
+ * previous one. */
+void _dk_app_stats_rotate(dk_stats_t* stats, uint64_t time)
+{
+    uint64_t elapsed = time - stats->window_start;
+    if (elapsed < DK_STATS_WINDOW)
+    {
+        return;
+    }
+
+    if (elapsed < 2 * DK_STATS_WINDOW)
+    {
+        stats->previous = stats->window;
+    }
+    else
+    {
+        _dk_histogram_reset(&stats->previous);
+    }
+    _dk_histogram_reset(&stats->window);
+    stats->window_start = time;
+}
+
+void _dk_app_stats_record(dk_stats_t* stats, uint64_t duration, uint64_t time)
+{
+    _dk_app_stats_rotate(stats, time);
+    _dk_histogram_record(&stats->total, duration);
+    _dk_histogram_record(&stats->window, duration);
+}
+
+void _dk_app_stats_query(const dk_stats_t* stats, bool window, dk_frame_stats_t* out)
+{
+    const dk_histogram_t* histogram = window ? &stats->previous : &stats->total;
+
+    out->count = histogram->count;
+    out->mean  = histogram->count ? histogram->sum / histogram->count : 0;
+    out->p50   = _dk_histogram_percentile(histogram, 50.0);
+    out->p95   = _dk_histogram_percentile(histogram, 95.0);
+    out->p99   = _dk_histogram_percentile(histogram, 99.0);
+    out->max   = histogram->max;
+}
+
+void _dk_app_stats_report(const char* name, const dk_stats_t* stats)
+{
+    dk_frame_stats_t out;
+    _dk_app_stats_query(stats, false, &out);
+
+    if (out.count == 0)
+    {
+        return;
+    }
+
+    DK_INFO("%s: %llu samples, mean %.1f us, p50 %.1f us, p95 %.1f us, p99 %.1f us, max %.1f us", name,
+    (unsigned long long)out.count, (double)out.mean / DK_NS_PER_US, (double)out.p50 / DK_NS_PER_US,
+    (double)out.p95 / DK_NS_PER_US, (double)out.p99 / DK_NS_PER_US, (double)out.max / DK_NS_PER_US);
+}
@@ -0,0 +1,284 @@
+#include "deako_pch.h"
+#include "deako_timer.h"
+
+#include "platform/deako_bits.h"
+
+#include <malloc.h>
+#include <string.h>
+
+#define DK_TIMER_WHEEL_RANGE ((uint64_t)1 << (DK_TIMER_WHEEL_LEVELS * DK_TIMER_WHEEL_BITS))
+
+/* first occupied slot at or after from, wrapping around; DK_TIMER_WHEEL_SLOTS if empty */
+static uint32_t _dk_timer_bitmap_next(const uint64_t* bits, uint32_t from)
+{
+    const uint32_t words = DK_TIMER_WHEEL_SLOTS / 64;
+
+    for (uint32_t i = 0; i <= words; i++)
+    {
+        uint32_t word  = (from / 64 + i) % words;
+        uint64_t value = bits[word];
+        if (i == 0)
+        {
+            value &= ~(uint64_t)0 << (from % 64);
+        }
+        else if (i == words)
+        {
+            value &= ((uint64_t)1 << (from % 64)) - 1;
+        }
+
+        if (value)
+        {
+            return word * 64 + dk_ctz64(value);
+        }
+    }
+
+    return DK_TIMER_WHEEL_SLOTS;
+}
+
+static void _dk_timer_link(dk_timer_wheel_t* wheel, uint32_t index)
+{
+    dk_timer_node_t* node = &wheel->nodes[index];
+
+    /* past the wheel's range the timer parks in the farthest slot and keeps its real expiry,
+     * each cascade relinks it from there until it is in range */
+    uint64_t delta = node->expires - wheel->current;
+    if (delta >= DK_TIMER_WHEEL_RANGE)
+    {
+        delta = DK_TIMER_WHEEL_RANGE - 1;
+    }
+    uint64_t tick = wheel->current + delta;
+
+    uint32_t level = 0;
+    while (delta >= ((uint64_t)1 << ((level + 1) * DK_TIMER_WHEEL_BITS)))
+    {
+        level++;
+    }
+
+    uint32_t slot = (uint32_t)(tick >> (level * DK_TIMER_WHEEL_BITS)) & DK_TIMER_WHEEL_MASK;
+    uint32_t head = level * DK_TIMER_WHEEL_SLOTS + slot;
+
+    node->slot = head;
+    node->prev = DK_TIMER_NONE;
+    node->next = wheel->heads[head];
+    if (node->next != DK_TIMER_NONE)
+    {
+        wheel->nodes[node->next].prev = index;
+    }
+    wheel->heads[head] = index;
+    wheel->occupied[level][slot / 64] |= (uint64_t)1 << (slot % 64);
+}
+
+static void _dk_timer_unlink(dk_timer_wheel_t* wheel, uint32_t index)
+{
+    dk_timer_node_t* node = &wheel->nodes[index];
+
+    if (node->prev != DK_TIMER_NONE)
+    {
+        wheel->nodes[node->prev].next = node->next;
+    }
+    else
+    {
+        wheel->heads[node->slot] = node->next;
+    }
+
+    if (node->next != DK_TIMER_NONE)
+    {
+        wheel->nodes[node->next].prev = node->prev;
+    }
+
+    if (wheel->heads[node->slot] == DK_TIMER_NONE)
+    {
+        uint32_t level = node->slot / DK_TIMER_WHEEL_SLOTS;
+        uint32_t slot  = node->slot % DK_TIMER_WHEEL_SLOTS;
+        wheel->occupied[level][slot / 64] &= ~((uint64_t)1 << (slot % 64));
+    }
+
+    node->slot = DK_TIMER_NONE;
+}
+
+static void _dk_timer_free(dk_timer_wheel_t* wheel, uint32_t index)
+{
+    dk_timer_node_t* node = &wheel->nodes[index];
+
+    node->generation = (node->generation + 1) ? node->generation + 1 : 1;
+    node->next       = wheel->free_head;
+    wheel->free_head = index;
+    wheel->count--;
+}
+
+static int _dk_timer_grow(dk_timer_wheel_t* wheel)
+{
+    uint32_t capacity      = wheel->capacity ? wheel->capacity * 2 : 256;
+    dk_timer_node_t* nodes = realloc(wheel->nodes, capacity * sizeof(*nodes));
+    DK_CHECK(nodes, DK_ERRNO_UNKNOWN);
+
+    for (uint32_t i = wheel->capacity; i < capacity; i++)
+    {
+        nodes[i].slot       = DK_TIMER_NONE;
+        nodes[i].generation = 1;
+        nodes[i].next       = (i + 1 < capacity) ? i + 1 : wheel->free_head;
+    }
+
+    wheel->free_head = wheel->capacity;
+    wheel->nodes     = nodes;
+    wheel->capacity  = capacity;
+
+    return DK_STATUS_OK;
+}
+
+static uint64_t _dk_timer_tick(const dk_timer_wheel_t* wheel, uint64_t deadline)
+{
+    uint64_t tick =
+    (deadline > wheel->start) ? (deadline - wheel->start + DK_TIMER_WHEEL_RESOLUTION - 1) / DK_TIMER_WHEEL_RESOLUTION : 0;
+    return (tick > wheel->current) ? tick : wheel->current + 1; // current tick has already fired
+}
+
+static void _dk_timer_cascade(dk_timer_wheel_t* wheel, uint32_t level)
+{
+    uint32_t slot  = (uint32_t)(wheel->current >> (level * DK_TIMER_WHEEL_BITS)) & DK_TIMER_WHEEL_MASK;
+    uint32_t head  = level * DK_TIMER_WHEEL_SLOTS + slot;
+    uint32_t index = wheel->heads[head];
+
+    wheel->heads[head] = DK_TIMER_NONE;
+    wheel->occupied[level][slot / 64] &= ~((uint64_t)1 << (slot % 64));
+
+    while (index != DK_TIMER_NONE)
+    {
+        uint32_t next = wheel->nodes[index].next;
+        _dk_timer_link(wheel, index);
+        index = next;
+    }
+}
+
+static void _dk_timer_step(dk_timer_wheel_t* wheel)
+{
+    wheel->current++;
+
+    for (uint32_t level = DK_TIMER_WHEEL_LEVELS - 1; level > 0; level--)
+    {
+        uint64_t mask = ((uint64_t)1 << (level * DK_TIMER_WHEEL_BITS)) - 1;
+        if ((wheel->current & mask) == 0)
+        {
+            _dk_timer_cascade(wheel, level);
+        }
+    }
+
+    /* pop one at a time, callbacks may schedule or cancel timers in this very slot */
+    uint32_t head = (uint32_t)wheel->current & DK_TIMER_WHEEL_MASK;
+    while (wheel->heads[head] != DK_TIMER_NONE)
+    {
+        uint32_t index        = wheel->heads[head];
+        dk_timer_node_t* node = &wheel->nodes[index];
+        dk_timer_cb callback  = node->timer.callback;
+
+        _dk_timer_unlink(wheel, index);
+        if (node->timer.timestep)
+        {
+            node->timer.timeout += node->timer.timestep;
+            node->expires = _dk_timer_tick(wheel, node->timer.timeout);
+            _dk_timer_link(wheel, index);
+        }
+        else
+        {
+            _dk_timer_free(wheel, index);
+        }
+
+        callback();
+    }
+}
+
+int _dk_timer_wheel_init(dk_timer_wheel_t* wheel, uint64_t time)
+{
+    memset(wheel, 0, sizeof(*wheel));
+    memset(wheel->heads, 0xff, sizeof(wheel->heads)); // DK_TIMER_NONE
+
+    wheel->start     = time;
+    wheel->free_head = DK_TIMER_NONE;
+
+    return _dk_timer_grow(wheel);
+}
+
+void _dk_timer_wheel_shutdown(dk_timer_wheel_t* wheel)
+{
+    free(wheel->nodes);
+    wheel->nodes    = NULL;
+    wheel->capacity = 0;
+    wheel->count    = 0;
+}
+
+dk_timer_handle_t _dk_timer_wheel_schedule(
+dk_timer_wheel_t* wheel, uint64_t deadline, uint64_t interval, dk_timer_cb callback)
+{
+    if (!callback || (wheel->free_head == DK_TIMER_NONE && _dk_timer_grow(wheel) != DK_STATUS_OK))
+    {
+        return 0;
+    }
+
+    uint32_t index        = wheel->free_head;
+    dk_timer_node_t* node = &wheel->nodes[index];
+    wheel->free_head      = node->next;
+    wheel->count++;
+
+    node->timer.timeout  = deadline;
+    node->timer.timestep = interval;
+    node->timer.callback = callback;
+    node->expires        = _dk_timer_tick(wheel, deadline);
+    _dk_timer_link(wheel, index);
+
+    return ((uint64_t)node->generation << 32) | index;
+}
+
+bool _dk_timer_wheel_cancel(dk_timer_wheel_t* wheel, dk_timer_handle_t handle)
+{
+    uint32_t index      = (uint32_t)handle;
+    uint32_t generation = (uint32_t)(handle >> 32);
+
+    if (index >= wheel->capacity || wheel->nodes[index].generation != generation ||
+    wheel->nodes[index].slot == DK_TIMER_NONE)
+    {
+        return false;
+    }
+
+    _dk_timer_unlink(wheel, index);
+    _dk_timer_free(wheel, index);
+
+    return true;
+}
+
+void _dk_timer_wheel_update(dk_timer_wheel_t* wheel, uint64_t time)
+{
+    uint64_t target = (time > wheel->start) ? (time - wheel->start) / DK_TIMER_WHEEL_RESOLUTION : 0;
+
+    if (wheel->count == 0)
+    {
+        wheel->current = (target > wheel->current) ? target : wheel->current;
+        return;
+    }
+
+    while (wheel->current < target)
+    {
+        _dk_timer_step(wheel);
+    }
+}
+
+/* Earliest time the wheel needs servicing: the next occupied level 0 slot, or the next
+ * cascade if only the upper levels hold timers. UINT64_MAX when empty. */
+uint64_t _dk_timer_wheel_next_deadline(const dk_timer_wheel_t* wheel)
+{
+    if (wheel->count == 0)
+    {
+        return UINT64_MAX;
+    }
+
+    uint64_t tick = (((wheel->current >> DK_TIMER_WHEEL_BITS) + 1) << DK_TIMER_WHEEL_BITS);
+
+    uint32_t from = (uint32_t)(wheel->current + 1) & DK_TIMER_WHEEL_MASK;
+    uint32_t slot = _dk_timer_bitmap_next(wheel->occupied[0], from);
+    if (slot != DK_TIMER_WHEEL_SLOTS)
+    {
+        uint64_t level0 = wheel->current + 1 + ((slot - from) & DK_TIMER_WHEEL_MASK);
+        tick            = (level0 < tick) ? level0 : tick;
+    }
+
+    return wheel->start + tick * DK_TIMER_WHEEL_RESOLUTION;
+}
@@ -0,0 +1,55 @@
+#ifndef DEAKO_TIMER_H
+#define DEAKO_TIMER_H
+
+#include "deako_internal.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define DK_TIMER_WHEEL_LEVELS 4
+#define DK_TIMER_WHEEL_BITS 8
+#define DK_TIMER_WHEEL_SLOTS (1u << DK_TIMER_WHEEL_BITS)
+#define DK_TIMER_WHEEL_MASK (DK_TIMER_WHEEL_SLOTS - 1)
+#define DK_TIMER_WHEEL_RESOLUTION DK_NS_PER_MS
+#define DK_TIMER_NONE UINT32_MAX
+
+/* generation << 32 | index, 0 is never a live timer */
+typedef uint64_t dk_timer_handle_t;
+
+typedef struct dk_timer_node {
+    dk_timer_t timer; // timeout = absolute deadline, timestep = repeat interval (0 = one-shot)
+    uint64_t expires; // wheel tick
+    uint32_t next;
+    uint32_t prev;
+    uint32_t slot;
+    uint32_t generation;
+} dk_timer_node_t;
+
+/* Hierarchical timing wheel: 4 levels of 256 slots at 1 ms per tick. Timers live in a
+ * growable node pool linked into slot lists by index, so insert and cancel are O(1) and
+ * a node is only touched again when its slot is cascaded or fired. */
+typedef struct dk_timer_wheel {
+    dk_timer_node_t* nodes;
+    uint32_t heads[DK_TIMER_WHEEL_LEVELS * DK_TIMER_WHEEL_SLOTS];
+    uint64_t occupied[DK_TIMER_WHEEL_LEVELS][DK_TIMER_WHEEL_SLOTS / 64];
+    uint64_t start;   // ns
+    uint64_t current; // tick
+    uint32_t capacity;
+    uint32_t count;
+    uint32_t free_head;
+} dk_timer_wheel_t;
+
+extern int _dk_timer_wheel_init(dk_timer_wheel_t* wheel, uint64_t time);
+extern void _dk_timer_wheel_shutdown(dk_timer_wheel_t* wheel);
+extern dk_timer_handle_t _dk_timer_wheel_schedule(
+dk_timer_wheel_t* wheel, uint64_t deadline, uint64_t interval, dk_timer_cb callback);
+extern bool _dk_timer_wheel_cancel(dk_timer_wheel_t* wheel, dk_timer_handle_t handle);
+extern void _dk_timer_wheel_update(dk_timer_wheel_t* wheel, uint64_t time);
+extern uint64_t _dk_timer_wheel_next_deadline(const dk_timer_wheel_t* wheel);
+
+/* delays and intervals in ns, callbacks run on the main thread from the app loop */
+extern dk_timer_handle_t dk_timer_schedule(uint64_t delay, dk_timer_cb callback);
+extern dk_timer_handle_t dk_timer_schedule_repeat(uint64_t delay, uint64_t interval, dk_timer_cb callback);
+extern bool dk_timer_cancel(dk_timer_handle_t handle);
+
+#endif // DEAKO_TIMER_H
@@ -0,0 +1,41 @@
+#include "deako_pch.h"
+#include "deako_app.h"
+
+#define DK_TIMESTEP_MAX_TICKS 8
+
+void _dk_app_timestep_init(dk_timestep_t* timestep, uint32_t rate, uint64_t time)
+{
+    timestep->step        = DK_NS_PER_S / (rate ? rate : 60);
+    timestep->accumulator = 0;
+    timestep->previous    = time;
+    timestep->tick_count  = 0;
+    timestep->dropped     = 0;
+    timestep->max_ticks   = DK_TIMESTEP_MAX_TICKS;
+    timestep->alpha       = 0.0;
+}
+
+/* Returns how many fixed ticks the caller has to run to catch up with time (ns). Anything
+ * beyond max_ticks is dropped so a slow frame cannot snowball into ever longer ones. */
+uint32_t _dk_app_timestep_advance(dk_timestep_t* timestep, uint64_t time)
+{
+    timestep->accumulator += time - timestep->previous;
+    timestep->previous = time;
+
+    uint64_t ticks = timestep->accumulator / timestep->step;
+    if (ticks > timestep->max_ticks)
+    {
+        timestep->dropped += (ticks - timestep->max_ticks) * timestep->step;
+        ticks = timestep->max_ticks;
+    }
+
+    timestep->accumulator -= ticks * timestep->step;
+    if (timestep->accumulator >= timestep->step)
+    {
+        timestep->accumulator %= timestep->step;
+    }
+
+    timestep->tick_count += ticks;
+    timestep->alpha = (double)timestep->accumulator / (double)timestep->step;
+
+    return (uint32_t)ticks;
+}
@@ -12,10 +12,42 @@ static void _dk_app_window_on_close(GLFWwindow* window)
 {
     dk_app_t* app   = (dk_app_t*)glfwGetWindowUserPointer(window);
     app->is_running = false;
+    _dk_input_close(app->input);
+}
+
+static void _dk_app_window_on_resize(GLFWwindow* window, int width, int height)
+{
+    dk_app_t* app = (dk_app_t*)glfwGetWindowUserPointer(window);
+    _dk_input_resize(app->input, width, height);
+}
+
+static void _dk_app_window_on_key(GLFWwindow* window, int key, int scancode, int action, int mods)
+{
+    dk_app_t* app = (dk_app_t*)glfwGetWindowUserPointer(window);
+    _dk_input_event(app->input, DK_REQUEST_TYPE_KEY, key, scancode, action, mods);
+}
+
+static void _dk_app_window_on_mouse_button(GLFWwindow* window, int button, int action, int mods)
+{
+    dk_app_t* app = (dk_app_t*)glfwGetWindowUserPointer(window);
+    _dk_input_event(app->input, DK_REQUEST_TYPE_MOUSE_BUTTON, button, 0, action, mods);
+}
+
+static void _dk_app_window_on_cursor(GLFWwindow* window, double x, double y)
+{
+    dk_app_t* app = (dk_app_t*)glfwGetWindowUserPointer(window);
+    _dk_input_cursor(app->input, x, y);
+}
+
+static void _dk_app_window_on_scroll(GLFWwindow* window, double x, double y)
+{
+    dk_app_t* app = (dk_app_t*)glfwGetWindowUserPointer(window);
+    _dk_input_scroll(app->input, x, y);
 }
 
 int _dk_app_window_init(dk_app_t* app, int width, int height, const char* title)
 {
+    DK_CHECK(app->input, DK_ERRNO_UNKNOWN); // _dk_app_input_init first
     DK_CHECK(glfwInit(), DK_ERRNO_UNKNOWN);
     glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API); // for vulkan
 
@@ -28,12 +60,82 @@ int _dk_app_window_init(dk_app_t* app, int width, int height, const char* title)
 
     glfwSetWindowUserPointer(glfw_window, (void*)app); /* easy access to the windows' data in glfw callbacks */
 
+    /* both input buffers start from the window's real size and cursor */
+    glfwGetFramebufferSize(glfw_window, &app->input->width, &app->input->height);
+    glfwGetCursorPos(glfw_window, &app->input->cursor_x, &app->input->cursor_y);
+    _dk_input_begin(app->snapshot, app->input);
+
     glfwSetWindowCloseCallback(glfw_window, _dk_app_window_on_close);
+    glfwSetFramebufferSizeCallback(glfw_window, _dk_app_window_on_resize);
+    glfwSetKeyCallback(glfw_window, _dk_app_window_on_key);
+    glfwSetMouseButtonCallback(glfw_window, _dk_app_window_on_mouse_button);
+    glfwSetCursorPosCallback(glfw_window, _dk_app_window_on_cursor);
+    glfwSetScrollCallback(glfw_window, _dk_app_window_on_scroll);
 
     return DK_STATUS_OK;
 }
 
 void _dk_app_window_poll(void)
 {
-    glfwPollEvents();
-}
\ No newline at end of file
+    DK_PROFILE_SCOPE("_dk_app_window_poll")
+    {
+        glfwPollEvents();
+    }
+}
+
+/* Before the window, whose callbacks write to app->input once they are set. */
+int _dk_app_input_init(dk_app_t* app)
+{
+    app->inputs = dk_arena_alloc(&app->arena, 2 * sizeof(*app->inputs), DK_CACHE_LINE);
+    DK_CHECK(app->inputs, DK_ERRNO_UNKNOWN);
+
+    _dk_input_begin(&app->inputs[0], NULL);
+    _dk_input_begin(&app->inputs[1], &app->inputs[0]);
+
+    app->input         = &app->inputs[0];
+    app->snapshot      = &app->inputs[1];
+    app->input_raw     = 0;
+    app->input_posted  = 0;
+    app->input_dropped = 0;
+
+    return DK_STATUS_OK;
+}
+
+/* Posts what the callbacks captured since the last frame, or what the replay recorded for
+ * it, and makes it the snapshot layers read; the other buffer starts capturing the next
+ * frame. */
+void _dk_app_input_flush(dk_app_t* app, uint64_t time)
+{
+    DK_PROFILE_SCOPE("_dk_app_input_flush")
+    {
+        dk_input_t* input = app->input;
+        if (app->replay.mode == DK_REPLAY_MODE_PLAY)
+        {
+            if (!_dk_replay_play(&app->replay, app->frame_count, input))
+            {
+                app->is_running = false; // recording exhausted, this is the last frame
+            }
+        }
+        else if (app->replay.mode == DK_REPLAY_MODE_RECORD)
+        {
+            _dk_replay_record(&app->replay, app->frame_count, time - app->start_time, input);
+        }
+
+        app->input_raw += input->raw;
+        app->input_posted += _dk_input_post(input);
+        app->input_dropped += input->dropped;
+
+        app->snapshot = input;
+        app->input    = (input == &app->inputs[0]) ? &app->inputs[1] : &app->inputs[0];
+        _dk_input_begin(app->input, input);
+    }
+}
+
+void _dk_app_input_report(const dk_app_t* app)
+{
+    if (app->input_raw)
+    {
+        DK_INFO("input: %llu callbacks coalesced into %llu requests, %llu dropped", (unsigned long long)app->input_raw,
+        (unsigned long long)app->input_posted, (unsigned long long)app->input_dropped);
+    }
+}
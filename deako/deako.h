@@ -4,12 +4,12 @@
 #include "app/deako_app.h"
 
 #include <log.h>
-#define DK_APP_TRACE(...) log_log(LOG_TRACE, __FILE__, __LINE__, __VA_ARGS__)
-#define DK_APP_DEBUG(...) log_log(LOG_DEBUG, __FILE__, __LINE__, __VA_ARGS__)
-#define DK_APP_INFO(...)  log_log(LOG_INFO,  __FILE__, __LINE__, __VA_ARGS__)
-#define DK_APP_WARN(...)  log_log(LOG_WARN,  __FILE__, __LINE__, __VA_ARGS__)
-#define DK_APP_ERROR(...) log_log(LOG_ERROR, __FILE__, __LINE__, __VA_ARGS__)
-#define DK_APP_FATAL(...) log_log(LOG_FATAL, __FILE__, __LINE__, __VA_ARGS__)
+#define DK_APP_TRACE(...) dk_log(LOG_TRACE, __FILE__, __LINE__, __VA_ARGS__)
+#define DK_APP_DEBUG(...) dk_log(LOG_DEBUG, __FILE__, __LINE__, __VA_ARGS__)
+#define DK_APP_INFO(...)  dk_log(LOG_INFO,  __FILE__, __LINE__, __VA_ARGS__)
+#define DK_APP_WARN(...)  dk_log(LOG_WARN,  __FILE__, __LINE__, __VA_ARGS__)
+#define DK_APP_ERROR(...) dk_log(LOG_ERROR, __FILE__, __LINE__, __VA_ARGS__)
+#define DK_APP_FATAL(...) dk_log(LOG_FATAL, __FILE__, __LINE__, __VA_ARGS__)
 
 typedef struct dk_config {
 	const char* app_name;
@@ -17,6 +17,27 @@ typedef struct dk_config {
 	uint32_t app_layer_count;
 	int window_width;
 	int window_height;
+	dk_pacer_mode pacer_mode;
+	uint32_t frame_rate;      // Hz, 0 = 60
+	uint32_t tick_rate;       // Hz, 0 = 60
+	const char* profile_path; // chrome trace written at shutdown, NULL = none
+	bool headless;            // no window, no GLFW calls
+	uint64_t frame_limit;     // stop after this many frames, 0 = until closed
+	dk_clock_mode clock_mode;
+	dk_clock_cb clock;        // DK_CLOCK_MODE_CUSTOM only
+	bool layer_stats;         // per layer on_update histograms
+	uint32_t job_workers;     // including the main thread, 0 = one per core
+	uint64_t frame_arena_reserve; // address space per frame buffer, committed as used, 0 = 64 MiB
+	uint32_t frame_arena_buffers; // 2 or 3, 0 = 2
+	bool frame_arena_huge_pages;  // back frame buffers with transparent huge pages where supported
+	bool log_async;           // format and write log messages on a background thread
+	dk_log_policy log_policy; // when a thread's log ring is full
+	uint32_t log_ring_size;   // bytes per logging thread, 0 = 64 KiB
+	const char* log_binary;   // binary log path instead of text, implies log_async
+	uint32_t request_capacity; // requests per frame and in flight from other threads, 0 = 4096
+	const char* record_path;  // window input and frame times recorded here, NULL = none
+	const char* replay_path;  // replays a recording headless on its own clock, then stops
+	const char* startup_trace_path; // time to first frame by phase and module as JSON, NULL = log only
 } dk_config_t;
 
 /* user-defined */
@@ -0,0 +1,40 @@
+#include "deako_pch.h"
+
+#ifdef DK_PLATFORM_WINDOWS
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+uint64_t dk_clock_now_ns(void)
+{
+#ifdef DK_PLATFORM_WINDOWS
+    static LARGE_INTEGER frequency = { 0 };
+    if (frequency.QuadPart == 0)
+    {
+        QueryPerformanceFrequency(&frequency);
+    }
+
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+
+    /* split to keep counter * 1e9 from overflowing */
+    uint64_t seconds   = (uint64_t)(counter.QuadPart / frequency.QuadPart);
+    uint64_t remainder = (uint64_t)(counter.QuadPart % frequency.QuadPart);
+    return seconds * DK_NS_PER_S + remainder * DK_NS_PER_S / (uint64_t)frequency.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * DK_NS_PER_S + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+void dk_clock_sleep_ns(uint64_t duration)
+{
+#ifdef DK_PLATFORM_WINDOWS
+    Sleep((DWORD)(duration / DK_NS_PER_MS));
+#else
+    struct timespec ts = { .tv_sec = (time_t)(duration / DK_NS_PER_S), .tv_nsec = (long)(duration % DK_NS_PER_S) };
+    nanosleep(&ts, NULL);
+#endif
+}
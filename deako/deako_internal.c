@@ -2,6 +2,7 @@
 #include "deako_pch.h"
 
 #include "app/deako_app.h"
+#include "jobs/deako_jobs.h"
 #include "renderer/deako_renderer.h"
 
 #include <stdint.h>
@@ -38,19 +39,82 @@ const char* dk_error_message_string(dk_errno error)
     return "unable to identify error type";
 }
 
-int _dk_module_init(dk_app_t* app, dk_module_t* module)
+int _dk_module_init(dk_module_t* module)
 {
+    int status = DK_ERRNO_UNKNOWN;
     switch (module->type)
     {
-    case DK_MODULE_TYPE_RENDERER: _dk_renderer_init((dk_renderer_t*)module); break;
-    case DK_MODULE_TYPE_UNKNOWN: return DK_ERRNO_UNKNOWN;
+    case DK_MODULE_TYPE_RENDERER: status = _dk_renderer_init((dk_renderer_t*)module); break;
+    case DK_MODULE_TYPE_JOBS: status = _dk_jobs_init((dk_jobs_t*)module); break;
+    case DK_MODULE_TYPE_APP:
+    case DK_MODULE_TYPE_UNKNOWN: break;
     }
 
-    app->modules = module;
+    return status;
+}
+
+int _dk_module_shutdown(dk_module_t* module)
+{
+    switch (module->type)
+    {
+    case DK_MODULE_TYPE_RENDERER: return _dk_renderer_shutdown();
+    case DK_MODULE_TYPE_JOBS: return _dk_jobs_shutdown();
+    case DK_MODULE_TYPE_APP:
+    case DK_MODULE_TYPE_UNKNOWN: break;
+    }
+
+    return DK_STATUS_OK;
+}
+
+int dk_module_arena_init(dk_module_t* module, uint64_t reserve)
+{
+    DK_CHECK(module, DK_ERRNO_UNKNOWN);
+    int status = dk_arena_init_virtual(&module->arena, reserve, DK_ARENA_FLAG_NONE);
+    DK_STATUS(status);
+    dk_arena_track(&module->arena, module->name ? module->name : "MODULE");
+
+    module->heap = NULL;
+    if (module->flags & DK_MODULE_FLAG_TLSF)
+    {
+        module->heap = dk_arena_alloc(&module->arena, sizeof(*module->heap), DK_ARENA_ALIGN);
+        DK_CHECK(module->heap, DK_ERRNO_UNKNOWN);
+        status = dk_tlsf_init(module->heap, &module->arena);
+        DK_STATUS(status);
+    }
 
     return DK_STATUS_OK;
 }
 
+void dk_module_arena_shutdown(dk_module_t* module)
+{
+    if (module->heap)
+    {
+        dk_tlsf_report(module->heap, module->name ? module->name : "MODULE");
+        dk_tlsf_shutdown(module->heap);
+        module->heap = NULL;
+    }
+
+    dk_arena_shutdown(&module->arena);
+}
+
+void* dk_module_alloc(dk_module_t* module, uint64_t size)
+{
+    return module->heap ? dk_tlsf_alloc(module->heap, size) : dk_arena_alloc(&module->arena, size, DK_ARENA_ALIGN);
+}
+
+void* dk_module_realloc(dk_module_t* module, void* ptr, uint64_t size)
+{
+    return module->heap ? dk_tlsf_realloc(module->heap, ptr, size) : NULL;
+}
+
+void dk_module_free(dk_module_t* module, void* ptr)
+{
+    if (module->heap)
+    {
+        dk_tlsf_free(module->heap, ptr);
+    }
+}
+
 void _dk_module_unref(dk_module_t* module)
 {
 }
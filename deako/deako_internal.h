@@ -2,20 +2,28 @@
 #define DEAKO_TYPES_H
 
 #include <log.h>
-#include <magic_memory.h> // TODO: temp?
+
+#include "log/deako_log.h"
+#include "memory/deako_arena.h"
+#include "memory/deako_tlsf.h"
+#include "profiler/deako_profiler.h"
 
 #include <stdint.h>
 
-#define DK_TRACE(...) log_log(LOG_TRACE, __FILE__, __LINE__, __VA_ARGS__)
-#define DK_DEBUG(...) log_log(LOG_DEBUG, __FILE__, __LINE__, __VA_ARGS__)
-#define DK_INFO(...) log_log(LOG_INFO, __FILE__, __LINE__, __VA_ARGS__)
-#define DK_WARN(...) log_log(LOG_WARN, __FILE__, __LINE__, __VA_ARGS__)
-#define DK_ERROR(...) log_log(LOG_ERROR, __FILE__, __LINE__, __VA_ARGS__)
-#define DK_FATAL(...) log_log(LOG_FATAL, __FILE__, __LINE__, __VA_ARGS__)
+#define DK_TRACE(...) dk_log(LOG_TRACE, __FILE__, __LINE__, __VA_ARGS__)
+#define DK_DEBUG(...) dk_log(LOG_DEBUG, __FILE__, __LINE__, __VA_ARGS__)
+#define DK_INFO(...) dk_log(LOG_INFO, __FILE__, __LINE__, __VA_ARGS__)
+#define DK_WARN(...) dk_log(LOG_WARN, __FILE__, __LINE__, __VA_ARGS__)
+#define DK_ERROR(...) dk_log(LOG_ERROR, __FILE__, __LINE__, __VA_ARGS__)
+#define DK_FATAL(...) dk_log(LOG_FATAL, __FILE__, __LINE__, __VA_ARGS__)
 
 #define DK_STATUS_RUN 1
 #define DK_STATUS_OK 0
 
+#define DK_NS_PER_US 1000ull
+#define DK_NS_PER_MS 1000000ull
+#define DK_NS_PER_S 1000000000ull
+
 #define DK_STRING(s) #s
 #define DK_STRINGIFY(s) DK_STRING(s)
 
@@ -56,35 +64,47 @@ extern void dk_error_print(dk_errno error, const char* location);
 extern const char* dk_error_name_string(dk_errno error);
 extern const char* dk_error_message_string(dk_errno error);
 
-typedef Magic_Arena dk_arena_t; // TODO: rename Magic_Arena
+typedef struct dk_request dk_request_t;
 
 typedef void (*dk_on_attach_cb)(void);
 typedef void (*dk_on_detach_cb)(void);
-typedef void (*dk_on_request_cb)(void);
+typedef void (*dk_on_update_cb)();
+typedef void (*dk_on_request_cb)(const dk_request_t* requests, uint32_t count); // valid during the call
 typedef void (*dk_timer_cb)(void);
 
 #define DK_MODULE_FIELDS         \
     const char* name;            \
     dk_arena_t arena;            \
+    dk_tlsf_t* heap;             \
     dk_module_type type;         \
     dk_on_attach_cb on_attach;   \
     dk_on_detach_cb on_detach;   \
     dk_on_request_cb on_request; \
+    uint32_t depends;            \
     uint32_t flags;
 
 typedef enum dk_module_type {
     DK_MODULE_TYPE_UNKNOWN = 0,
     DK_MODULE_TYPE_APP,
     DK_MODULE_TYPE_RENDERER,
+    DK_MODULE_TYPE_JOBS,
 } dk_module_type;
 
 typedef enum dk_module_flag {
     DK_MODULE_TYPE_NONE     = 0,
     DK_RENDERER_FLAG_VULKAN = 1 << 0,
+    DK_MODULE_FLAG_LAZY     = 1 << 29, // initialized on first dk_app_module or after the first frame
+    DK_MODULE_FLAG_TLSF     = 1 << 30, // dk_module_alloc goes through a TLSF heap in the module arena
 } dk_module_flag;
 
+#define DK_MODULE_FLAG_COMMON (DK_MODULE_FLAG_LAZY | DK_MODULE_FLAG_TLSF) // flags every module type understands
+
+#define DK_MODULE_MAX       32
+#define DK_MODULE_BIT(type) (1u << (type)) // for dk_module_t.depends, modules initialized first
+
 typedef enum dk_handle_type {
     DK_HANDLE_TYPE_UNKNOWN = 0,
+    DK_HANDLE_TYPE_COUNT,
 } dk_handle_type;
 
 typedef enum dk_handle_flag {
@@ -96,31 +116,83 @@ typedef enum dk_handle_flag {
 
 typedef enum dk_request_type {
     DK_REQUEST_TYPE_UNKNOWN = 0,
+    DK_REQUEST_TYPE_WINDOW_CLOSE,
+    DK_REQUEST_TYPE_WINDOW_RESIZE,
+    DK_REQUEST_TYPE_KEY,
+    DK_REQUEST_TYPE_MOUSE_BUTTON,
+    DK_REQUEST_TYPE_CURSOR,
+    DK_REQUEST_TYPE_SCROLL,
+    DK_REQUEST_TYPE_USER = 0x100, // app-defined types start here
 } dk_request_type;
 
 typedef struct dk_module {
     DK_MODULE_FIELDS
 } dk_module_t;
 
+/* index into the type's pool, generation 0 is never issued so a zeroed handle is null */
 typedef struct dk_handle {
     dk_handle_type type;
+    uint32_t index;
+    uint32_t generation;
 } dk_handle_t;
 
 typedef struct dk_timer {
-    uint64_t timeout;
-    uint64_t timestep;
+    uint64_t timeout;  // ns
+    uint64_t timestep; // ns
     dk_timer_cb callback;
 } dk_timer_t;
 
-typedef struct dk_request {
+/* One event, fixed size so a frame's requests sit in one contiguous array. */
+struct dk_request {
     dk_request_type type;
-} dk_request_t;
+    uint32_t source; // app-defined, e.g. the posting layer
+    uint64_t time;   // ns on the app clock, stamped when posted if 0
+    union {
+        struct {
+            int32_t width;
+            int32_t height;
+        } resize;
+        struct {
+            int32_t key;
+            int32_t scancode;
+            int32_t action;
+            int32_t mods;
+        } key;
+        struct {
+            int32_t button;
+            int32_t action;
+            int32_t mods;
+        } mouse_button;
+        struct {
+            double x;
+            double y;
+        } cursor, scroll;
+        uint64_t user[4];
+    } data;
+};
 
 typedef struct dk_app dk_app_t;
 
-extern int _dk_module_init(dk_app_t* app, dk_module_t* module);
+typedef uint64_t (*dk_clock_cb)(void);
+
+extern uint64_t dk_clock_now_ns(void);
+extern void dk_clock_sleep_ns(uint64_t duration);
+
+extern int _dk_module_init(dk_module_t* module);
+extern int _dk_module_shutdown(dk_module_t* module);
 extern void _dk_module_unref(dk_module_t* module);
 
 extern void _dk_modules_on_attach(dk_module_t* module);
 
+/* reserves the module's arena, committed as it fills and accounted under the module's name,
+ * and sets up module->heap inside it when the module has DK_MODULE_FLAG_TLSF */
+extern int dk_module_arena_init(dk_module_t* module, uint64_t reserve);
+extern void dk_module_arena_shutdown(dk_module_t* module);
+
+/* From the module's heap, or bump allocated from its arena without one; then free does
+ * nothing and realloc fails, the memory goes when the arena does. Not thread safe. */
+extern void* dk_module_alloc(dk_module_t* module, uint64_t size);
+extern void* dk_module_realloc(dk_module_t* module, void* ptr, uint64_t size);
+extern void dk_module_free(dk_module_t* module, void* ptr);
+
 #endif // DEAKO_TYPES_H
\ No newline at end of file
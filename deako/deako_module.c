@@ -0,0 +1,296 @@
+#include "deako_pch.h"
+#include "deako_module.h"
+
+#include <string.h>
+
+static const char* _dk_module_name(const dk_module_t* module)
+{
+    return module->name ? module->name : "MODULE";
+}
+
+int _dk_module_register(dk_module_registry_t* registry, dk_arena_t* arena, const dk_module_t* module, uint64_t size)
+{
+    DK_CHECK(registry && module && size >= sizeof(*module), DK_ERRNO_UNKNOWN);
+    DK_CHECK(registry->count < DK_MODULE_MAX, DK_ERRNO_UNKNOWN);
+    for (uint32_t i = 0; i < registry->count; i++)
+    {
+        DK_CHECK(registry->entries[i].module->type != module->type, DK_ERRNO_UNKNOWN);
+    }
+
+    dk_module_t* copy = dk_arena_alloc(arena, size, DK_ARENA_ALIGN);
+    DK_CHECK(copy, DK_ERRNO_UNKNOWN);
+    memcpy(copy, module, size);
+
+    dk_module_entry_t* entry = &registry->entries[registry->count++];
+    entry->module            = copy;
+    entry->registry          = registry;
+    entry->state             = DK_MODULE_STATE_REGISTERED;
+    entry->wave              = 0;
+    entry->init_begin        = 0;
+    entry->init_time         = 0;
+    entry->status            = DK_STATUS_OK;
+
+    return DK_STATUS_OK;
+}
+
+/* A module's wave is one past its latest dependency's, found by relaxing until nothing
+ * moves; more passes than modules means a cycle. */
+static int _dk_modules_sort(dk_module_registry_t* registry)
+{
+    uint32_t types = 0;
+    for (uint32_t i = 0; i < registry->count; i++)
+    {
+        types |= DK_MODULE_BIT(registry->entries[i].module->type);
+    }
+
+    for (uint32_t i = 0; i < registry->count; i++)
+    {
+        dk_module_t* module = registry->entries[i].module;
+        if ((module->depends & ~types) || (module->depends & DK_MODULE_BIT(module->type)))
+        {
+            DK_ERROR("module %s depends on a module that is not registered", module->name);
+            DK_ERROR_HANDLE(DK_ERRNO_UNKNOWN);
+        }
+    }
+
+    bool changed = true;
+    for (uint32_t pass = 0; changed; pass++)
+    {
+        if (pass > registry->count)
+        {
+            DK_ERROR("module dependencies form a cycle");
+            DK_ERROR_HANDLE(DK_ERRNO_UNKNOWN);
+        }
+
+        changed = false;
+        for (uint32_t i = 0; i < registry->count; i++)
+        {
+            dk_module_entry_t* entry = &registry->entries[i];
+            for (uint32_t j = 0; j < registry->count; j++)
+            {
+                dk_module_entry_t* dependency = &registry->entries[j];
+                if ((entry->module->depends & DK_MODULE_BIT(dependency->module->type)) && entry->wave <= dependency->wave)
+                {
+                    entry->wave = dependency->wave + 1;
+                    changed     = true;
+                }
+            }
+        }
+    }
+
+    uint32_t count       = 0;
+    registry->wave_count = 0;
+    for (uint32_t w = 0; count < registry->count; w++)
+    {
+        registry->waves[w] = count;
+        for (uint32_t i = 0; i < registry->count; i++)
+        {
+            if (registry->entries[i].wave == w)
+            {
+                registry->order[count++] = i;
+            }
+        }
+        registry->wave_count = w + 1;
+    }
+    registry->waves[registry->wave_count] = count;
+
+    return DK_STATUS_OK;
+}
+
+static dk_module_t* _dk_module_start(dk_module_entry_t* entry);
+
+/* dependencies first, then init and on_attach on the calling thread */
+static void _dk_module_run(dk_module_entry_t* entry)
+{
+    dk_module_registry_t* registry = entry->registry;
+    dk_module_t* module            = entry->module;
+
+    for (uint32_t i = 0; i < registry->count; i++)
+    {
+        dk_module_entry_t* dependency = &registry->entries[i];
+        if ((module->depends & DK_MODULE_BIT(dependency->module->type)) && !_dk_module_start(dependency))
+        {
+            entry->status = DK_ERRNO_UNKNOWN;
+            dk_atomic_store_u32(&entry->state, DK_MODULE_STATE_FAILED);
+            return;
+        }
+    }
+
+    entry->init_begin = dk_clock_now_ns();
+    DK_PROFILE_SCOPE(_dk_module_name(module))
+    {
+        entry->status = _dk_module_init(module);
+        if (entry->status >= DK_STATUS_OK && module->on_attach)
+        {
+            module->on_attach();
+        }
+    }
+    entry->init_time = dk_clock_now_ns() - entry->init_begin;
+
+    /* only what initialized is shut down; dependencies finished first, so they come earlier */
+    if (entry->status >= DK_STATUS_OK)
+    {
+        uint32_t slot           = dk_atomic_add_u32(&registry->started_count, 1);
+        registry->started[slot] = (uint32_t)(entry - registry->entries);
+    }
+
+    dk_atomic_store_u32(&entry->state, entry->status >= DK_STATUS_OK ? DK_MODULE_STATE_READY : DK_MODULE_STATE_FAILED);
+}
+
+/* the first caller initializes the module, everyone else waits for it */
+static dk_module_t* _dk_module_start(dk_module_entry_t* entry)
+{
+    uint32_t state = dk_atomic_load_u32(&entry->state);
+    while (state == DK_MODULE_STATE_REGISTERED || state == DK_MODULE_STATE_DEFERRED)
+    {
+        if (dk_atomic_cas_u32(&entry->state, &state, DK_MODULE_STATE_STARTING))
+        {
+            _dk_module_run(entry);
+            break;
+        }
+    }
+
+    while ((state = dk_atomic_load_u32(&entry->state)) == DK_MODULE_STATE_STARTING)
+    {
+        dk_thread_yield();
+    }
+
+    return (state == DK_MODULE_STATE_READY) ? entry->module : NULL;
+}
+
+static void _dk_modules_start_one(void* data)
+{
+    _dk_module_start(data);
+}
+
+int _dk_modules_init(dk_module_registry_t* registry)
+{
+    uint64_t begin = dk_clock_now_ns();
+    int status     = _dk_modules_sort(registry);
+    DK_STATUS(status);
+
+    /* the jobs module makes the thread that initializes it worker 0, that has to be this one */
+    for (uint32_t i = 0; i < registry->count; i++)
+    {
+        dk_module_t* module = registry->entries[i].module;
+        if ((module->flags & DK_MODULE_FLAG_LAZY) && module->type != DK_MODULE_TYPE_JOBS)
+        {
+            registry->entries[i].state = DK_MODULE_STATE_DEFERRED;
+        }
+    }
+
+    registry->started_count = 0;
+    registry->deferred      = (dk_job_counter_t){ 0 };
+    for (uint32_t w = 0; w < registry->wave_count; w++)
+    {
+        dk_job_decl_t decls[DK_MODULE_MAX];
+        uint32_t count = 0;
+        for (uint32_t i = registry->waves[w]; i < registry->waves[w + 1]; i++)
+        {
+            dk_module_entry_t* entry = &registry->entries[registry->order[i]];
+            if (dk_atomic_load_u32(&entry->state) != DK_MODULE_STATE_DEFERRED)
+            {
+                decls[count].fn     = _dk_modules_start_one;
+                decls[count++].data = entry;
+            }
+        }
+
+        /* a lone module runs on the calling thread, the jobs module has to */
+        if (count == 1)
+        {
+            _dk_modules_start_one(decls[0].data);
+        }
+        else if (count > 1)
+        {
+            dk_job_counter_t counter = { 0 };
+            dk_jobs_run(decls, count, &counter);
+            dk_jobs_wait(&counter);
+        }
+
+        for (uint32_t i = 0; i < count; i++)
+        {
+            dk_module_entry_t* entry = decls[i].data;
+            if (entry->state == DK_MODULE_STATE_FAILED)
+            {
+                DK_ERROR("module %s failed to initialize (%d)", _dk_module_name(entry->module), entry->status);
+                status = DK_ERRNO_UNKNOWN;
+            }
+        }
+        DK_STATUS(status);
+    }
+
+    registry->init_time = dk_clock_now_ns() - begin;
+
+    return DK_STATUS_OK;
+}
+
+void _dk_modules_start_deferred(dk_module_registry_t* registry)
+{
+    dk_job_decl_t decls[DK_MODULE_MAX];
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < registry->count; i++)
+    {
+        if (dk_atomic_load_u32(&registry->entries[i].state) == DK_MODULE_STATE_DEFERRED)
+        {
+            decls[count].fn     = _dk_modules_start_one;
+            decls[count++].data = &registry->entries[i];
+        }
+    }
+
+    if (count)
+    {
+        dk_jobs_run(decls, count, &registry->deferred);
+    }
+}
+
+dk_module_t* _dk_module_require(dk_module_registry_t* registry, dk_module_type type)
+{
+    for (uint32_t i = 0; i < registry->count; i++)
+    {
+        if (registry->entries[i].module->type == type)
+        {
+            return _dk_module_start(&registry->entries[i]);
+        }
+    }
+
+    return NULL;
+}
+
+void _dk_modules_shutdown(dk_module_registry_t* registry)
+{
+    dk_jobs_wait(&registry->deferred);
+
+    while (registry->started_count)
+    {
+        dk_module_entry_t* entry = &registry->entries[registry->started[--registry->started_count]];
+        _dk_module_shutdown(entry->module);
+    }
+}
+
+void _dk_modules_report(const dk_module_registry_t* registry)
+{
+    uint64_t sum      = 0;
+    uint64_t critical = 0;
+    for (uint32_t w = 0; w < registry->wave_count; w++)
+    {
+        uint64_t longest = 0;
+        for (uint32_t i = registry->waves[w]; i < registry->waves[w + 1]; i++)
+        {
+            const dk_module_entry_t* entry = &registry->entries[registry->order[i]];
+            if (entry->state == DK_MODULE_STATE_DEFERRED)
+            {
+                DK_INFO("module %s: wave %u, deferred", _dk_module_name(entry->module), w);
+                continue;
+            }
+
+            DK_INFO("module %s: wave %u, %.3f ms", _dk_module_name(entry->module), w, (double)entry->init_time / DK_NS_PER_MS);
+            sum += entry->init_time;
+            longest = (entry->init_time > longest) ? entry->init_time : longest;
+        }
+        critical += longest;
+    }
+
+    DK_INFO("modules: %u in %u waves, %.3f ms (critical path %.3f ms, sum %.3f ms)", registry->count,
+    registry->wave_count, (double)registry->init_time / DK_NS_PER_MS, (double)critical / DK_NS_PER_MS,
+    (double)sum / DK_NS_PER_MS);
+}
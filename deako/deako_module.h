@@ -0,0 +1,58 @@
+#ifndef DEAKO_MODULE_H
+#define DEAKO_MODULE_H
+
+#include "deako_internal.h"
+#include "jobs/deako_jobs.h"
+
+#include <stdint.h>
+
+typedef enum dk_module_state {
+    DK_MODULE_STATE_REGISTERED = 0,
+    DK_MODULE_STATE_DEFERRED, // DK_MODULE_FLAG_LAZY, waiting for first use or the first frame
+    DK_MODULE_STATE_STARTING,
+    DK_MODULE_STATE_READY,
+    DK_MODULE_STATE_FAILED,
+} dk_module_state;
+
+typedef struct dk_module_registry dk_module_registry_t;
+
+typedef struct dk_module_entry {
+    dk_module_t* module; // the registry's copy, as large as the module type
+    dk_module_registry_t* registry;
+    volatile uint32_t state; // dk_module_state
+    uint32_t wave;
+    uint64_t init_begin; // ns
+    uint64_t init_time;  // ns
+    int status;
+} dk_module_entry_t;
+
+/* Modules grouped into waves by their dependencies; a wave's modules initialize
+ * concurrently on the job workers once every earlier wave has finished, so startup takes
+ * about the critical path rather than the sum. Lazy modules are left out and start on first
+ * use, or in the background once _dk_modules_start_deferred runs. */
+struct dk_module_registry {
+    dk_module_entry_t entries[DK_MODULE_MAX];
+    uint32_t order[DK_MODULE_MAX];     // entry indices, wave by wave
+    uint32_t waves[DK_MODULE_MAX + 1]; // wave_count + 1 offsets into order
+    uint32_t wave_count;
+    uint32_t count;
+    uint32_t started[DK_MODULE_MAX]; // entry indices in the order they started, shut down in reverse
+    volatile uint32_t started_count;
+    dk_job_counter_t deferred; // background starts still running
+    uint64_t init_time;        // ns, the whole of _dk_modules_init
+};
+
+/* copies size bytes of module, one module per type */
+extern int _dk_module_register(dk_module_registry_t* registry, dk_arena_t* arena, const dk_module_t* module, uint64_t size);
+extern int _dk_modules_init(dk_module_registry_t* registry);
+extern void _dk_modules_shutdown(dk_module_registry_t* registry);
+extern void _dk_modules_report(const dk_module_registry_t* registry);
+
+/* Starts the module of that type if it has not, its dependencies first, and waits for it;
+ * from any thread. NULL if it is not registered or failed. */
+extern dk_module_t* _dk_module_require(dk_module_registry_t* registry, dk_module_type type);
+
+/* hands every lazy module nobody asked for yet to the job workers */
+extern void _dk_modules_start_deferred(dk_module_registry_t* registry);
+
+#endif // DEAKO_MODULE_H
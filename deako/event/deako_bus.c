@@ -0,0 +1,188 @@
+#include "deako_pch.h"
+#include "deako_bus.h"
+
+#include "platform/deako_atomic.h"
+#include "platform/deako_bits.h"
+
+#include <string.h>
+
+int _dk_bus_init(
+dk_bus_t* bus, dk_arena_t* arena, uint32_t capacity, const dk_bus_subscriber_t* subscribers, uint32_t count)
+{
+    DK_CHECK(bus && arena && (subscribers || count == 0), DK_ERRNO_UNKNOWN);
+    memset(bus, 0, sizeof(*bus));
+
+    uint32_t total = 0;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        if (!subscribers[i].on_request)
+        {
+            continue;
+        }
+
+        if (subscribers[i].topics == 0)
+        {
+            bus->everything_count++;
+        }
+        for (uint64_t bits = subscribers[i].topics; bits; bits &= bits - 1)
+        {
+            bus->offsets[dk_ctz64(bits) + 1]++;
+            total++;
+        }
+        bus->active |= subscribers[i].topics;
+    }
+
+    for (uint32_t t = 0; t < DK_TOPIC_COUNT; t++)
+    {
+        bus->offsets[t + 1] += bus->offsets[t];
+    }
+
+    uint32_t topical      = total ? total : 1;
+    uint32_t everything   = bus->everything_count ? bus->everything_count : 1;
+    uint64_t batch        = capacity ? capacity : 1;
+    bus->subscribers      = dk_arena_alloc(arena, topical * sizeof(*bus->subscribers), 8);
+    bus->subscriber_index = dk_arena_alloc(arena, topical * sizeof(*bus->subscriber_index), 4);
+    bus->everything       = dk_arena_alloc(arena, everything * sizeof(*bus->everything), 8);
+    bus->everything_index = dk_arena_alloc(arena, everything * sizeof(*bus->everything_index), 4);
+    bus->sorted           = dk_arena_alloc(arena, batch * sizeof(*bus->sorted), DK_CACHE_LINE);
+    bus->topics           = dk_arena_alloc(arena, batch, DK_CACHE_LINE);
+    DK_CHECK(bus->subscribers && bus->subscriber_index && bus->everything && bus->everything_index, DK_ERRNO_UNKNOWN);
+    DK_CHECK(bus->sorted && bus->topics, DK_ERRNO_UNKNOWN);
+    bus->capacity = capacity;
+
+    /* fill each topic's array in subscriber order, everything_count doubles as a cursor */
+    uint32_t cursors[DK_TOPIC_COUNT];
+    memcpy(cursors, bus->offsets, sizeof(cursors));
+    bus->everything_count = 0;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        if (!subscribers[i].on_request)
+        {
+            continue;
+        }
+
+        if (subscribers[i].topics == 0)
+        {
+            bus->everything[bus->everything_count]         = subscribers[i].on_request;
+            bus->everything_index[bus->everything_count++] = i;
+        }
+        for (uint64_t bits = subscribers[i].topics; bits; bits &= bits - 1)
+        {
+            uint32_t slot               = cursors[dk_ctz64(bits)]++;
+            bus->subscribers[slot]      = subscribers[i].on_request;
+            bus->subscriber_index[slot] = i;
+        }
+    }
+
+    return DK_STATUS_OK;
+}
+
+void _dk_bus_publish(dk_bus_t* bus, const dk_request_t* requests, uint32_t count)
+{
+    if (count == 0)
+    {
+        return;
+    }
+    bus->published += count;
+
+    for (uint32_t i = 0; i < bus->everything_count; i++)
+    {
+        bus->everything[i](requests, count);
+    }
+    bus->delivered += bus->everything_count;
+
+    if (!bus->active)
+    {
+        bus->unheard += bus->everything_count ? 0 : count;
+        return;
+    }
+
+    uint32_t counts[DK_TOPIC_COUNT] = { 0 };
+    uint64_t present                = 0;
+    count                           = (count < bus->capacity) ? count : bus->capacity;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        uint32_t topic = DK_TOPIC_ID(requests[i].type);
+        bus->topics[i] = (uint8_t)topic;
+        present |= (uint64_t)1 << topic;
+        counts[topic]++;
+    }
+
+    uint64_t wanted = present & bus->active;
+    if (!bus->everything_count)
+    {
+        for (uint64_t bits = present & ~wanted; bits; bits &= bits - 1)
+        {
+            bus->unheard += counts[dk_ctz64(bits)];
+        }
+    }
+
+    /* a batch of one topic is already its own bucket */
+    const dk_request_t* sorted      = requests;
+    uint32_t starts[DK_TOPIC_COUNT] = { 0 };
+    if (present == wanted && dk_popcount64(present) == 1)
+    {
+        starts[dk_ctz64(present)] = 0;
+    }
+    else
+    {
+        uint32_t offset = 0;
+        for (uint64_t bits = wanted; bits; bits &= bits - 1)
+        {
+            uint32_t topic = dk_ctz64(bits);
+            starts[topic]  = offset;
+            offset += counts[topic];
+        }
+
+        uint32_t cursors[DK_TOPIC_COUNT];
+        memcpy(cursors, starts, sizeof(cursors));
+        for (uint32_t i = 0; i < count; i++)
+        {
+            uint32_t topic = bus->topics[i];
+            if (wanted & ((uint64_t)1 << topic))
+            {
+                bus->sorted[cursors[topic]++] = requests[i];
+            }
+        }
+        sorted = bus->sorted;
+    }
+
+    for (uint64_t bits = wanted; bits; bits &= bits - 1)
+    {
+        uint32_t topic = dk_ctz64(bits);
+        for (uint32_t s = bus->offsets[topic]; s < bus->offsets[topic + 1]; s++)
+        {
+            bus->subscribers[s](sorted + starts[topic], counts[topic]);
+        }
+        bus->delivered += bus->offsets[topic + 1] - bus->offsets[topic];
+    }
+}
+
+/* by index, two subscribers may well share one callback */
+void _dk_bus_rebind(dk_bus_t* bus, uint32_t subscriber, dk_on_request_cb to)
+{
+    for (uint32_t i = 0; i < bus->offsets[DK_TOPIC_COUNT]; i++)
+    {
+        if (bus->subscriber_index[i] == subscriber)
+        {
+            bus->subscribers[i] = to;
+        }
+    }
+
+    for (uint32_t i = 0; i < bus->everything_count; i++)
+    {
+        if (bus->everything_index[i] == subscriber)
+        {
+            bus->everything[i] = to;
+        }
+    }
+}
+
+void _dk_bus_report(const dk_bus_t* bus)
+{
+    if (bus->published)
+    {
+        DK_INFO("bus: %llu requests published, %llu subscriber calls, %llu unheard",
+        (unsigned long long)bus->published, (unsigned long long)bus->delivered, (unsigned long long)bus->unheard);
+    }
+}
@@ -0,0 +1,60 @@
+#ifndef DEAKO_BUS_H
+#define DEAKO_BUS_H
+
+#include "deako_internal.h"
+
+#include <stdint.h>
+
+#define DK_TOPIC_COUNT 64 // one bit each in a subscriber's interest mask
+#define DK_TOPIC_USER  8  // topic of DK_REQUEST_TYPE_USER, the user types follow
+
+/* Compile-time topic of a request type: the built-in types keep their value and
+ * DK_REQUEST_TYPE_USER + n becomes DK_TOPIC_USER + n. Types past the last topic share
+ * topic 0. */
+#define DK_TOPIC_ID(type)                                                                  \
+((uint32_t)(type) >= DK_REQUEST_TYPE_USER ?                                                \
+((uint32_t)(type) - DK_REQUEST_TYPE_USER < DK_TOPIC_COUNT - DK_TOPIC_USER ?                \
+DK_TOPIC_USER + (uint32_t)(type) - DK_REQUEST_TYPE_USER :                                  \
+0) :                                                                                       \
+((uint32_t)(type) < DK_TOPIC_USER ? (uint32_t)(type) : 0))
+#define DK_TOPIC(type) ((uint64_t)1 << DK_TOPIC_ID(type))
+
+typedef struct dk_bus_subscriber {
+    dk_on_request_cb on_request;
+    uint64_t topics; // DK_TOPIC() bits, 0 = every request as one batch
+} dk_bus_subscriber_t;
+
+/* Per-topic subscriber arrays built once from the interest masks. Publishing buckets a
+ * batch by topic and hands each subscriber only its topics' slices, one call per topic, so
+ * requests keep their order within a topic but not across topics. Subscribers with no mask
+ * get the whole batch in order, as before. */
+typedef struct dk_bus {
+    dk_on_request_cb* subscribers;         // topic by topic
+    uint32_t* subscriber_index;            // the subscribers[] entry each one came from
+    uint32_t offsets[DK_TOPIC_COUNT + 1];  // into subscribers
+    dk_on_request_cb* everything;          // subscribers without a mask
+    uint32_t* everything_index;
+    uint32_t everything_count;
+    uint64_t active;                       // topics with at least one subscriber
+    dk_request_t* sorted;                  // the batch bucketed by topic
+    uint8_t* topics;                       // topic of each request in the batch
+    uint32_t capacity;
+    uint64_t published;
+    uint64_t delivered; // subscriber calls
+    uint64_t unheard;   // requests no subscriber wanted
+} dk_bus_t;
+
+/* capacity = largest batch that will be published; everything comes from arena */
+extern int _dk_bus_init(
+dk_bus_t* bus, dk_arena_t* arena, uint32_t capacity, const dk_bus_subscriber_t* subscribers, uint32_t count);
+
+/* main thread only, requests stay valid for the duration of the calls */
+extern void _dk_bus_publish(dk_bus_t* bus, const dk_request_t* requests, uint32_t count);
+
+/* Swaps the callback of subscribers[subscriber] as passed to _dk_bus_init in place, between
+ * publishes. A subscriber that had no callback when the bus was built stays without one. */
+extern void _dk_bus_rebind(dk_bus_t* bus, uint32_t subscriber, dk_on_request_cb to);
+
+extern void _dk_bus_report(const dk_bus_t* bus);
+
+#endif // DEAKO_BUS_H
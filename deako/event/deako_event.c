@@ -0,0 +1,141 @@
+#include "deako_pch.h"
+#include "deako_event.h"
+
+#include "platform/deako_thread.h"
+
+#define DK_EVENT_CAPACITY 4096
+
+static uint32_t _dk_event_capacity(uint32_t capacity)
+{
+    uint32_t size = 1;
+    while (size < capacity)
+    {
+        size <<= 1;
+    }
+    return size;
+}
+
+/* appends to the filling frame buffer, owner only */
+static bool _dk_event_push(dk_event_queue_t* queue, const dk_request_t* request)
+{
+    uint32_t* count = &queue->counts[queue->index];
+    if (*count == queue->capacity)
+    {
+        dk_atomic_add_u64(&queue->dropped, 1);
+        return false;
+    }
+
+    queue->frames[queue->index][(*count)++] = *request;
+    queue->posted++;
+    return true;
+}
+
+int _dk_event_queue_init(dk_event_queue_t* queue, dk_arena_t* arena, uint32_t capacity)
+{
+    DK_CHECK(queue && arena, DK_ERRNO_UNKNOWN);
+
+    capacity = _dk_event_capacity(capacity ? capacity : DK_EVENT_CAPACITY);
+
+    queue->cells = dk_arena_alloc(arena, (uint64_t)capacity * sizeof(*queue->cells), DK_CACHE_LINE);
+    DK_CHECK(queue->cells, DK_ERRNO_UNKNOWN);
+    for (uint32_t i = 0; i < capacity; i++)
+    {
+        queue->cells[i].sequence = i;
+    }
+
+    for (uint32_t i = 0; i < DK_EVENT_FRAMES; i++)
+    {
+        queue->frames[i] = dk_arena_alloc(arena, (uint64_t)capacity * sizeof(dk_request_t), DK_CACHE_LINE);
+        DK_CHECK(queue->frames[i], DK_ERRNO_UNKNOWN);
+        queue->counts[i] = 0;
+    }
+
+    queue->tail      = 0;
+    queue->head      = 0;
+    queue->mask      = capacity - 1;
+    queue->capacity  = capacity;
+    queue->index     = 0;
+    queue->owner     = dk_thread_id();
+    queue->dropped   = 0;
+    queue->posted    = 0;
+    queue->batch_max = 0;
+
+    return DK_STATUS_OK;
+}
+
+bool _dk_event_post(dk_event_queue_t* queue, const dk_request_t* request)
+{
+    if (dk_thread_id() == queue->owner)
+    {
+        return _dk_event_push(queue, request);
+    }
+
+    uint64_t position = dk_atomic_load_u64(&queue->tail);
+    dk_event_cell_t* cell;
+    for (;;)
+    {
+        cell              = &queue->cells[position & queue->mask];
+        uint64_t sequence = dk_atomic_load_u64(&cell->sequence);
+        int64_t diff      = (int64_t)(sequence - position);
+        if (diff == 0)
+        {
+            if (dk_atomic_cas_u64(&queue->tail, &position, position + 1))
+            {
+                break;
+            }
+        }
+        else if (diff < 0)
+        {
+            dk_atomic_add_u64(&queue->dropped, 1); // a full lap behind the owner
+            return false;
+        }
+        else
+        {
+            position = dk_atomic_load_u64(&queue->tail);
+        }
+    }
+
+    cell->request = *request;
+    dk_atomic_store_u64(&cell->sequence, position + 1);
+    return true;
+}
+
+uint32_t _dk_event_collect(dk_event_queue_t* queue, const dk_request_t** requests)
+{
+    /* stops at the first slot still being written, its producer lands in the next frame, and
+     * once the batch is full: producers refill the ring while it drains */
+    while (queue->counts[queue->index] < queue->capacity)
+    {
+        dk_event_cell_t* cell = &queue->cells[queue->head & queue->mask];
+        if (dk_atomic_load_u64(&cell->sequence) != queue->head + 1)
+        {
+            break;
+        }
+
+        _dk_event_push(queue, &cell->request);
+        dk_atomic_store_u64(&cell->sequence, queue->head + queue->mask + 1);
+        queue->head++;
+    }
+
+    uint32_t index = queue->index;
+    uint32_t count = queue->counts[index];
+
+    queue->index                = (index + 1) % DK_EVENT_FRAMES;
+    queue->counts[queue->index] = 0;
+    queue->batch_max            = (count > queue->batch_max) ? count : queue->batch_max;
+
+    *requests = queue->frames[index];
+    return count;
+}
+
+void _dk_event_report(const dk_event_queue_t* queue)
+{
+    DK_INFO("requests: %llu posted, largest frame batch %llu", (unsigned long long)queue->posted,
+    (unsigned long long)queue->batch_max);
+
+    uint64_t dropped = dk_atomic_load_u64(&queue->dropped);
+    if (dropped)
+    {
+        DK_WARN("requests: %llu dropped, raise request_capacity", (unsigned long long)dropped);
+    }
+}
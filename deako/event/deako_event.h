@@ -0,0 +1,50 @@
+#ifndef DEAKO_EVENT_H
+#define DEAKO_EVENT_H
+
+#include "deako_internal.h"
+#include "platform/deako_atomic.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define DK_EVENT_FRAMES 2 // the batch being dispatched and the one filling up
+
+typedef struct dk_event_cell {
+    volatile uint64_t sequence;
+    dk_request_t request;
+} dk_event_cell_t;
+
+/* Requests posted during frame N are dispatched together at the start of frame N + 1.
+ * The owning (main) thread appends straight to the filling frame buffer; any other thread
+ * goes through a bounded lock-free MPSC ring (Vyukov) that the owner drains into that
+ * buffer at collect time, so a frame's batch is always one contiguous array. A full ring or
+ * buffer drops the request and counts it. */
+typedef struct dk_event_queue {
+    DK_ALIGNED(DK_CACHE_LINE) volatile uint64_t tail; // next ring slot producers claim
+    DK_ALIGNED(DK_CACHE_LINE) uint64_t head;          // next ring slot the owner reads
+    dk_event_cell_t* cells;
+    uint32_t mask;
+    dk_request_t* frames[DK_EVENT_FRAMES];
+    uint32_t counts[DK_EVENT_FRAMES];
+    uint32_t capacity; // requests per frame buffer
+    uint32_t index;    // frame buffer filling up
+    uint32_t owner;    // dk_thread_id of the thread that collects
+    volatile uint64_t dropped;
+    uint64_t posted;
+    uint64_t batch_max;
+} dk_event_queue_t;
+
+/* queue must be DK_CACHE_LINE aligned; its buffers come from arena. capacity is rounded up
+ * to a power of two, 0 = 4096. The calling thread becomes the owner. */
+extern int _dk_event_queue_init(dk_event_queue_t* queue, dk_arena_t* arena, uint32_t capacity);
+
+/* from any thread, false if the request was dropped */
+extern bool _dk_event_post(dk_event_queue_t* queue, const dk_request_t* request);
+
+/* Owner only. Closes the filling frame, pulling in everything producers have finished
+ * posting, and returns it; valid until the next collect. */
+extern uint32_t _dk_event_collect(dk_event_queue_t* queue, const dk_request_t** requests);
+
+extern void _dk_event_report(const dk_event_queue_t* queue);
+
+#endif // DEAKO_EVENT_H
@@ -0,0 +1,530 @@
+#include "deako_pch.h"
+#include "deako_jobs.h"
+
+#include <malloc.h>
+#include <stdlib.h>
+
+#define DK_JOBS_DEQUE_MASK (DK_JOBS_DEQUE_CAPACITY - 1)
+#define DK_JOBS_RING_MASK (DK_JOBS_RING_CAPACITY - 1)
+#define DK_JOBS_SPIN_COUNT 64 // failed steal rounds before a worker goes to sleep
+
+typedef struct dk_jobs_state {
+    dk_jobs_t module;
+    dk_job_worker_t* workers[DK_JOBS_MAX_WORKERS];
+    uint32_t worker_count;
+    volatile uint32_t pending;  // pushed but not yet taken
+    volatile uint32_t sleeping; // workers parked on wake
+    volatile uint32_t running;
+    dk_mutex_t mutex;
+    dk_cond_t wake;
+} dk_jobs_state_t;
+
+static dk_jobs_state_t* g_jobs = NULL;
+static DK_THREAD_LOCAL dk_job_worker_t* t_worker = NULL;
+
+static bool _dk_jobs_push(dk_job_deque_t* deque, dk_job_t* job)
+{
+    int64_t bottom = (int64_t)deque->bottom;
+    int64_t top    = (int64_t)dk_atomic_load_u64(&deque->top);
+    if (bottom - top >= DK_JOBS_DEQUE_CAPACITY)
+    {
+        return false;
+    }
+
+    deque->slots[bottom & DK_JOBS_DEQUE_MASK] = job;
+    dk_atomic_store_u64(&deque->bottom, (uint64_t)(bottom + 1));
+    return true;
+}
+
+static dk_job_t* _dk_jobs_pop(dk_job_deque_t* deque)
+{
+    int64_t bottom = (int64_t)deque->bottom - 1;
+    dk_atomic_exchange_u64(&deque->bottom, (uint64_t)bottom); // full fence against thieves
+    int64_t top = (int64_t)dk_atomic_load_u64(&deque->top);
+
+    if (top > bottom)
+    {
+        dk_atomic_store_u64(&deque->bottom, (uint64_t)(bottom + 1));
+        return NULL;
+    }
+
+    dk_job_t* job = deque->slots[bottom & DK_JOBS_DEQUE_MASK];
+    if (top == bottom)
+    {
+        /* last job, race the thieves for it */
+        uint64_t expected = (uint64_t)top;
+        if (!dk_atomic_cas_u64(&deque->top, &expected, (uint64_t)(top + 1)))
+        {
+            job = NULL;
+        }
+        dk_atomic_store_u64(&deque->bottom, (uint64_t)(bottom + 1));
+    }
+
+    return job;
+}
+
+static dk_job_t* _dk_jobs_steal(dk_job_deque_t* deque)
+{
+    int64_t top = (int64_t)dk_atomic_load_u64(&deque->top);
+    dk_atomic_fence();
+    int64_t bottom = (int64_t)dk_atomic_load_u64(&deque->bottom);
+
+    if (top >= bottom)
+    {
+        return NULL;
+    }
+
+    dk_job_t* job     = deque->slots[top & DK_JOBS_DEQUE_MASK];
+    uint64_t expected = (uint64_t)top;
+    if (!dk_atomic_cas_u64(&deque->top, &expected, (uint64_t)(top + 1)))
+    {
+        return NULL; // lost to the owner or another thief
+    }
+
+    return job;
+}
+
+static uint64_t _dk_jobs_random(dk_job_worker_t* worker)
+{
+    /* xorshift64 */
+    worker->rng ^= worker->rng << 13;
+    worker->rng ^= worker->rng >> 7;
+    worker->rng ^= worker->rng << 17;
+    return worker->rng;
+}
+
+static dk_job_t* _dk_jobs_next(dk_job_worker_t* worker)
+{
+    dk_job_t* job = _dk_jobs_pop(&worker->deque);
+
+    if (!job && g_jobs->worker_count > 1)
+    {
+        uint32_t start = (uint32_t)(_dk_jobs_random(worker) % g_jobs->worker_count);
+        for (uint32_t i = 0; i < g_jobs->worker_count && !job; i++)
+        {
+            dk_job_worker_t* victim = g_jobs->workers[(start + i) % g_jobs->worker_count];
+            if (victim != worker)
+            {
+                job = _dk_jobs_steal(&victim->deque);
+                worker->stolen += (job != NULL);
+            }
+        }
+    }
+
+    if (job)
+    {
+        dk_atomic_add_u32(&g_jobs->pending, (uint32_t)-1);
+    }
+
+    return job;
+}
+
+static void _dk_jobs_execute(dk_job_worker_t* worker, dk_job_t* job);
+
+/* A slot comes round again DK_JOBS_RING_CAPACITY submissions later. If its job is still
+ * queued or parked by then, help with other jobs until it has been taken. */
+static dk_job_t* _dk_jobs_alloc(dk_job_worker_t* worker, const dk_job_t* job)
+{
+    for (;;)
+    {
+        dk_job_t* slot = &worker->ring[worker->ring_head & DK_JOBS_RING_MASK];
+        if (!dk_atomic_load_u32(&slot->busy))
+        {
+            worker->ring_head++;
+            *slot      = *job;
+            slot->busy = 1;
+            return slot;
+        }
+
+        dk_job_t* other = _dk_jobs_next(worker);
+        if (other)
+        {
+            _dk_jobs_execute(worker, other);
+        }
+        else
+        {
+            dk_atomic_pause();
+        }
+    }
+}
+
+static void _dk_jobs_lock(dk_job_counter_t* counter)
+{
+    uint32_t expected = 0;
+    while (!dk_atomic_cas_u32(&counter->lock, &expected, 1))
+    {
+        expected = 0;
+        dk_atomic_pause();
+    }
+}
+
+static void _dk_jobs_unlock(dk_job_counter_t* counter)
+{
+    dk_atomic_store_u32(&counter->lock, 0);
+}
+
+static void _dk_jobs_submit(dk_job_worker_t* worker, dk_job_t* job)
+{
+    if (!_dk_jobs_push(&worker->deque, job))
+    {
+        _dk_jobs_execute(worker, job);
+        return;
+    }
+
+    dk_atomic_add_u32(&g_jobs->pending, 1);
+    dk_atomic_fence();
+    if (dk_atomic_load_u32(&g_jobs->sleeping))
+    {
+        dk_mutex_lock(&g_jobs->mutex);
+        dk_cond_signal(&g_jobs->wake);
+        dk_mutex_unlock(&g_jobs->mutex);
+    }
+}
+
+/* Holds job back until dependency reaches zero, so no worker ever blocks on one. */
+static void _dk_jobs_park(dk_job_worker_t* worker, dk_job_t* job, dk_job_counter_t* dependency)
+{
+    _dk_jobs_lock(dependency);
+    if (dk_atomic_load_u32(&dependency->value) != 0)
+    {
+        job->next           = dependency->waiting;
+        dependency->waiting = job;
+        _dk_jobs_unlock(dependency);
+        return;
+    }
+    _dk_jobs_unlock(dependency);
+
+    _dk_jobs_submit(worker, job);
+}
+
+/* Only the drop to zero takes the lock, and waiters also wait for the lock to be released,
+ * so a counter on the waiter's stack is never touched after it returns. Whoever gets the
+ * counter to zero queues the jobs parked on it, or runs them itself outside the job
+ * system. */
+static void _dk_jobs_done(dk_job_worker_t* worker, dk_job_counter_t* counter)
+{
+    if (!counter)
+    {
+        return;
+    }
+
+    uint32_t value = dk_atomic_load_u32(&counter->value);
+    while (value > 1)
+    {
+        if (dk_atomic_cas_u32(&counter->value, &value, value - 1))
+        {
+            return;
+        }
+    }
+
+    _dk_jobs_lock(counter);
+    dk_job_t* job = NULL;
+    if (dk_atomic_add_u32(&counter->value, (uint32_t)-1) == 1) // not raised again meanwhile
+    {
+        job              = counter->waiting;
+        counter->waiting = NULL;
+    }
+    _dk_jobs_unlock(counter);
+
+    while (job)
+    {
+        dk_job_t* next = job->next;
+        if (worker)
+        {
+            _dk_jobs_submit(worker, job);
+        }
+        else
+        {
+            _dk_jobs_execute(NULL, job);
+        }
+        job = next;
+    }
+}
+
+static void _dk_jobs_execute(dk_job_worker_t* worker, dk_job_t* job)
+{
+    /* off its queue nothing else refers to the slot, so it is freed before the job runs;
+     * a job that submits a full ring's worth can't end up waiting on its own slot */
+    dk_job_t run = *job;
+    dk_atomic_store_u32(&job->busy, 0);
+
+    if (run.range_fn)
+    {
+        /* keep the front half, publish the back half for thieves */
+        while (run.end - run.begin > run.grain)
+        {
+            uint32_t middle = run.begin + (run.end - run.begin) / 2;
+
+            dk_job_t split = run;
+            split.begin    = middle;
+            run.end        = middle;
+
+            if (run.counter)
+            {
+                dk_atomic_add_u32(&run.counter->value, 1);
+            }
+            _dk_jobs_submit(worker, _dk_jobs_alloc(worker, &split));
+        }
+
+        run.range_fn(run.data, run.begin, run.end);
+    }
+    else
+    {
+        run.fn(run.data);
+    }
+
+    if (worker)
+    {
+        worker->executed++;
+    }
+    _dk_jobs_done(worker, run.counter);
+}
+
+static void _dk_jobs_worker_main(void* data)
+{
+    dk_job_worker_t* worker = (dk_job_worker_t*)data;
+    t_worker                = worker;
+    dk_profile_thread_name("job worker");
+
+    uint32_t idle = 0;
+    while (dk_atomic_load_u32(&g_jobs->running))
+    {
+        dk_job_t* job = _dk_jobs_next(worker);
+        if (job)
+        {
+            _dk_jobs_execute(worker, job);
+            idle = 0;
+            continue;
+        }
+
+        if (++idle < DK_JOBS_SPIN_COUNT)
+        {
+            dk_atomic_pause();
+            continue;
+        }
+
+        /* sleeping is published before pending is re-checked, and submitters bump pending
+         * before reading sleeping, so one of the two always sees the other */
+        dk_mutex_lock(&g_jobs->mutex);
+        dk_atomic_add_u32(&g_jobs->sleeping, 1);
+        dk_atomic_fence();
+        while (dk_atomic_load_u32(&g_jobs->pending) == 0 && dk_atomic_load_u32(&g_jobs->running))
+        {
+            dk_cond_wait(&g_jobs->wake, &g_jobs->mutex);
+        }
+        dk_atomic_add_u32(&g_jobs->sleeping, (uint32_t)-1);
+        dk_mutex_unlock(&g_jobs->mutex);
+        idle = 0;
+    }
+}
+
+static dk_job_worker_t* _dk_jobs_worker_create(uint32_t index)
+{
+    dk_job_worker_t* worker = dk_arena_alloc(&g_jobs->module.arena, sizeof(*worker), DK_CACHE_LINE);
+    if (!worker)
+    {
+        return NULL;
+    }
+
+    worker->deque.top    = 0;
+    worker->deque.bottom = 0;
+    worker->ring_head    = 0;
+    worker->index        = index;
+    worker->rng          = 0x9e3779b97f4a7c15ull * (index + 1);
+    worker->executed     = 0;
+    worker->stolen       = 0;
+
+    for (uint32_t i = 0; i < DK_JOBS_RING_CAPACITY; i++)
+    {
+        worker->ring[i].busy = 0;
+    }
+
+    return worker;
+}
+
+int _dk_jobs_init(dk_jobs_t* module)
+{
+    g_jobs = malloc(sizeof(*g_jobs));
+    DK_CHECK(g_jobs, DK_ERRNO_UNKNOWN);
+    g_jobs->module = *module;
+
+    uint32_t count = module->worker_count ? module->worker_count : dk_cpu_count();
+    count          = (count < DK_JOBS_MAX_WORKERS) ? count : DK_JOBS_MAX_WORKERS;
+    count          = count ? count : 1;
+
+    /* workers live in the module arena, released all at once at shutdown */
+    uint64_t arena_size = (uint64_t)count * (sizeof(dk_job_worker_t) + DK_CACHE_LINE);
+    int status = dk_module_arena_init((dk_module_t*)&g_jobs->module, arena_size);
+    DK_STATUS(status);
+
+    g_jobs->worker_count = 0;
+    g_jobs->pending      = 0;
+    g_jobs->sleeping     = 0;
+    g_jobs->running      = 1;
+    dk_mutex_init(&g_jobs->mutex);
+    dk_cond_init(&g_jobs->wake);
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        g_jobs->workers[i] = _dk_jobs_worker_create(i);
+        DK_CHECK(g_jobs->workers[i], DK_ERRNO_UNKNOWN);
+        g_jobs->worker_count++;
+    }
+
+    /* _dk_modules_init never defers this module, the calling thread is the main thread; it
+     * takes part whenever it waits */
+    t_worker = g_jobs->workers[0];
+
+    for (uint32_t i = 1; i < count; i++)
+    {
+        status = dk_thread_create(&g_jobs->workers[i]->thread, _dk_jobs_worker_main, g_jobs->workers[i]);
+        DK_STATUS(status);
+    }
+
+    DK_DEBUG("Initialized: %s (%u workers)", g_jobs->module.name, count);
+
+    return DK_STATUS_OK;
+}
+
+int _dk_jobs_shutdown(void)
+{
+    if (!g_jobs)
+    {
+        return DK_STATUS_OK;
+    }
+
+    dk_mutex_lock(&g_jobs->mutex);
+    dk_atomic_store_u32(&g_jobs->running, 0);
+    dk_cond_broadcast(&g_jobs->wake);
+    dk_mutex_unlock(&g_jobs->mutex);
+
+    for (uint32_t i = 1; i < g_jobs->worker_count; i++)
+    {
+        dk_thread_join(&g_jobs->workers[i]->thread);
+    }
+
+    for (uint32_t i = 0; i < g_jobs->worker_count; i++)
+    {
+        DK_DEBUG("job worker %u: %llu executed, %llu stolen", i, (unsigned long long)g_jobs->workers[i]->executed,
+        (unsigned long long)g_jobs->workers[i]->stolen);
+    }
+    dk_module_arena_shutdown((dk_module_t*)&g_jobs->module);
+
+    dk_cond_destroy(&g_jobs->wake);
+    dk_mutex_destroy(&g_jobs->mutex);
+    free(g_jobs);
+    g_jobs   = NULL;
+    t_worker = NULL;
+
+    return DK_STATUS_OK;
+}
+
+void dk_jobs_run_after(
+const dk_job_decl_t* decls, uint32_t count, dk_job_counter_t* counter, dk_job_counter_t* dependency)
+{
+    dk_job_worker_t* worker = t_worker;
+
+    if (counter)
+    {
+        dk_atomic_add_u32(&counter->value, count);
+    }
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        dk_job_t job = {
+            .fn      = decls[i].fn,
+            .data    = decls[i].data,
+            .counter = counter,
+        };
+
+        if (!worker)
+        {
+            /* no job system, or called from a thread it does not own */
+            if (dependency)
+            {
+                dk_jobs_wait(dependency);
+            }
+            _dk_jobs_execute(NULL, &job);
+            continue;
+        }
+
+        dk_job_t* slot = _dk_jobs_alloc(worker, &job);
+        if (dependency)
+        {
+            _dk_jobs_park(worker, slot, dependency);
+        }
+        else
+        {
+            _dk_jobs_submit(worker, slot);
+        }
+    }
+}
+
+void dk_jobs_run(const dk_job_decl_t* decls, uint32_t count, dk_job_counter_t* counter)
+{
+    dk_jobs_run_after(decls, count, counter, NULL);
+}
+
+void dk_jobs_wait(dk_job_counter_t* counter)
+{
+    dk_job_worker_t* worker = t_worker;
+
+    while (dk_atomic_load_u32(&counter->value) != 0 || dk_atomic_load_u32(&counter->lock) != 0)
+    {
+        dk_job_t* job = worker ? _dk_jobs_next(worker) : NULL;
+        if (job)
+        {
+            _dk_jobs_execute(worker, job);
+        }
+        else
+        {
+            dk_atomic_pause();
+        }
+    }
+}
+
+void dk_jobs_parallel_for(uint32_t count, uint32_t grain, dk_job_range_fn fn, void* data)
+{
+    dk_job_worker_t* worker = t_worker;
+
+    if (count == 0)
+    {
+        return;
+    }
+
+    if (!worker)
+    {
+        fn(data, 0, count);
+        return;
+    }
+
+    if (grain == 0)
+    {
+        /* a few ranges per worker leaves room to rebalance uneven ranges by stealing */
+        grain = count / (g_jobs->worker_count * 4);
+        grain = grain ? grain : 1;
+    }
+
+    dk_job_counter_t counter = { 1, 0, NULL };
+    dk_job_t job             = {
+        .range_fn = fn,
+        .data     = data,
+        .begin    = 0,
+        .end      = count,
+        .grain    = grain,
+        .counter  = &counter,
+    };
+
+    _dk_jobs_execute(worker, &job);
+    dk_jobs_wait(&counter);
+}
+
+uint32_t dk_jobs_worker_count(void)
+{
+    return g_jobs ? g_jobs->worker_count : 1;
+}
+
+uint32_t dk_jobs_worker_index(void)
+{
+    return t_worker ? t_worker->index : 0;
+}
@@ -0,0 +1,81 @@
+#ifndef DEAKO_JOBS_H
+#define DEAKO_JOBS_H
+
+#include "deako_internal.h"
+#include "platform/deako_atomic.h"
+#include "platform/deako_thread.h"
+
+#define DK_JOBS_MAX_WORKERS 64
+#define DK_JOBS_DEQUE_CAPACITY 4096 // per worker, a full deque runs the job inline
+#define DK_JOBS_RING_CAPACITY 4096  // jobs in flight per submitting thread, more waits for a slot
+
+typedef void (*dk_job_fn)(void* data);
+typedef void (*dk_job_range_fn)(void* data, uint32_t begin, uint32_t end);
+
+/* Number of jobs still to finish; zero-initialise, then pass to dk_jobs_run and wait on
+ * it, or hand it to dk_jobs_run_after as the dependency of the next batch. Jobs submitted
+ * after it are parked on it until it reaches zero, then queued by whoever got it there. */
+typedef struct dk_job_counter {
+    volatile uint32_t value;
+    volatile uint32_t lock; // guards waiting against the drop to zero
+    struct dk_job* waiting; // parked dependents
+} dk_job_counter_t;
+
+typedef struct dk_job_decl {
+    dk_job_fn fn;
+    void* data;
+} dk_job_decl_t;
+
+typedef struct dk_job {
+    dk_job_fn fn;
+    dk_job_range_fn range_fn;
+    void* data;
+    uint32_t begin;
+    uint32_t end;
+    uint32_t grain;
+    volatile uint32_t busy; // ring slot taken until the job starts
+    dk_job_counter_t* counter;
+    struct dk_job* next; // in its dependency's waiting list
+} dk_job_t;
+
+/* Chase-Lev deque: the owner pushes and pops at bottom, thieves take from top. */
+typedef struct dk_job_deque {
+    DK_ALIGNED(DK_CACHE_LINE) volatile uint64_t top;
+    DK_ALIGNED(DK_CACHE_LINE) volatile uint64_t bottom;
+    dk_job_t* volatile slots[DK_JOBS_DEQUE_CAPACITY];
+} dk_job_deque_t;
+
+typedef struct dk_job_worker {
+    dk_job_deque_t deque;
+    dk_job_t ring[DK_JOBS_RING_CAPACITY];
+    uint32_t ring_head;
+    uint32_t index; // 0 is the main thread
+    uint64_t rng;
+    uint64_t executed;
+    uint64_t stolen;
+    dk_thread_t thread;
+} dk_job_worker_t;
+
+typedef struct dk_jobs {
+    DK_MODULE_FIELDS
+    uint32_t worker_count; // including the main thread, 0 = one per core
+} dk_jobs_t;
+
+extern int _dk_jobs_init(dk_jobs_t* module);
+extern int _dk_jobs_shutdown(void);
+
+extern void dk_jobs_run(const dk_job_decl_t* decls, uint32_t count, dk_job_counter_t* counter);
+extern void dk_jobs_run_after(
+const dk_job_decl_t* decls, uint32_t count, dk_job_counter_t* counter, dk_job_counter_t* dependency);
+
+/* runs other jobs on the calling thread until counter reaches zero */
+extern void dk_jobs_wait(dk_job_counter_t* counter);
+
+/* splits [0, count) in halves until a range is at most grain long (0 = picked from the
+ * worker count) and blocks until every range has run */
+extern void dk_jobs_parallel_for(uint32_t count, uint32_t grain, dk_job_range_fn fn, void* data);
+
+extern uint32_t dk_jobs_worker_count(void);
+extern uint32_t dk_jobs_worker_index(void);
+
+#endif // DEAKO_JOBS_H
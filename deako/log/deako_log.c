@@ -0,0 +1,1169 @@
+#include "deako_pch.h"
+#include "deako_log.h"
+
+#include "platform/deako_atomic.h"
+#include "platform/deako_thread.h"
+
+#include <malloc.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define DK_LOG_RING_SIZE (64u * 1024)
+#define DK_LOG_RECORD_MAX 2048      // bytes, longer %s arguments are truncated
+#define DK_LOG_BATCH_SIZE (64u * 1024)
+#define DK_LOG_IDLE_TIMEOUT (2 * DK_NS_PER_MS)
+#define DK_LOG_ALIGN(n) (((n) + 7u) & ~7u)
+#define DK_LOG_BINARY_MAGIC 0x474c4b44u // "DKLG"
+#define DK_LOG_BINARY_VERSION 1
+
+/* Fixed header of every queued message, followed by its arguments in 8 byte slots in format
+ * order. size 0 marks the unused tail of the ring before a wrap. */
+typedef struct dk_log_record {
+    uint32_t size; // bytes including header and arguments
+    int32_t level;
+    int32_t line;
+    uint32_t reserved;
+    const char* file;
+    const char* fmt;
+    uint64_t time; // dk_clock_now_ns
+} dk_log_record_t;
+
+/* Single producer ring owned by one thread, head is only advanced by the owner and tail only
+ * by the log thread. Both count bytes and are never wrapped. */
+typedef struct dk_log_ring {
+    DK_ALIGNED(DK_CACHE_LINE) volatile uint64_t head;
+    DK_ALIGNED(DK_CACHE_LINE) volatile uint64_t tail;
+    volatile uint64_t dropped;
+    struct dk_log_ring* next;
+    uint8_t* data;
+    uint32_t capacity;
+} dk_log_ring_t;
+
+/* Binary log layout, native endianness and type sizes: one header, then a stream of site
+ * definitions and messages. A site is written the first time one of its messages is, every
+ * message after that only carries the site id, a timestamp and the packed argument slots. */
+typedef struct dk_log_binary_header {
+    uint32_t magic;
+    uint32_t version;
+    int64_t wall;    // time_t at origin
+    uint64_t origin; // dk_clock_now_ns at wall
+} dk_log_binary_header_t;
+
+typedef struct dk_log_binary_site {
+    uint32_t tag; // 0
+    uint32_t id;
+    int32_t level;
+    int32_t line;
+    uint32_t file_length; // followed by file then fmt, not terminated
+    uint32_t fmt_length;
+} dk_log_binary_site_t;
+
+typedef struct dk_log_binary_message {
+    uint32_t id;   // non-zero
+    uint32_t size; // argument bytes that follow
+    uint64_t time;
+} dk_log_binary_message_t;
+
+typedef struct dk_log_site {
+    const char* fmt;
+    const char* file;
+    int32_t line;
+    uint32_t id; // 0 = empty slot
+} dk_log_site_t;
+
+typedef struct dk_log_state {
+    void* volatile rings; // dk_log_ring_t list, push only
+    volatile uint32_t running;
+    dk_log_policy policy;
+    uint32_t ring_size;
+    dk_thread_t thread;
+    dk_mutex_t mutex;
+    dk_cond_t wake;
+    dk_cond_t flushed;
+    uint64_t flush_request; // guarded by mutex
+    uint64_t flush_done;
+    char* batch;
+    size_t batch_size;
+    FILE* output; // stderr, or the binary log
+    bool binary;
+    dk_log_site_t* sites; // open addressing on fmt, file and line
+    uint32_t site_capacity;
+    uint32_t site_count;
+    uint64_t site_failures; // binary messages lost to a failed site table grow
+    int64_t wall;           // time_t at origin
+    uint64_t origin;
+    int64_t stamp_time; // strftime cache
+    char stamp[32];
+} dk_log_state_t;
+
+/* A single conversion specification, parsed the same way on both sides of the ring. */
+typedef struct dk_log_spec {
+    const char* begin;  // '%'
+    const char* dot;    // precision, or length if there is none
+    const char* length; // first length modifier, or the conversion if there is none
+    const char* end;    // one past the conversion
+    bool star_width;
+    bool star_precision;
+    int precision; // -1 if absent or given by '*'
+    char modifier; // 0, 'H' (hh), 'h', 'l', 'q' (ll), 'j', 'z', 't', 'L'
+    char conversion;
+} dk_log_spec_t;
+
+static dk_log_state_t g_log = { 0 };
+static DK_THREAD_LOCAL dk_log_ring_t* t_log_ring = NULL;
+
+static const char* g_log_colors[] = { "\x1b[94m", "\x1b[36m", "\x1b[32m", "\x1b[33m", "\x1b[31m", "\x1b[35m" };
+
+static const char* _dk_log_spec(const char* fmt, dk_log_spec_t* spec)
+{
+    spec->begin          = fmt++;
+    spec->star_width     = false;
+    spec->star_precision = false;
+    spec->precision      = -1;
+    spec->modifier       = 0;
+
+    while (*fmt && strchr("-+ #0'", *fmt))
+    {
+        fmt++;
+    }
+
+    if (*fmt == '*')
+    {
+        spec->star_width = true;
+        fmt++;
+    }
+    while (*fmt >= '0' && *fmt <= '9')
+    {
+        fmt++;
+    }
+
+    spec->dot = fmt;
+    if (*fmt == '.')
+    {
+        fmt++;
+        if (*fmt == '*')
+        {
+            spec->star_precision = true;
+            fmt++;
+        }
+        else
+        {
+            spec->precision = 0;
+            while (*fmt >= '0' && *fmt <= '9')
+            {
+                spec->precision = spec->precision * 10 + (*fmt++ - '0');
+            }
+        }
+    }
+
+    spec->length = fmt;
+    if (*fmt && strchr("hljztL", *fmt))
+    {
+        spec->modifier = *fmt++;
+        if ((spec->modifier == 'h' || spec->modifier == 'l') && *fmt == spec->modifier)
+        {
+            spec->modifier = (spec->modifier == 'h') ? 'H' : 'q';
+            fmt++;
+        }
+    }
+
+    spec->conversion = *fmt;
+    spec->end        = *fmt ? fmt + 1 : fmt;
+    return spec->end;
+}
+
+static dk_log_ring_t* _dk_log_ring(void)
+{
+    if (t_log_ring)
+    {
+        return t_log_ring;
+    }
+
+    dk_log_ring_t* ring = NULL;
+#ifdef DK_PLATFORM_WINDOWS
+    ring = _aligned_malloc(sizeof(*ring), DK_CACHE_LINE);
+#else
+    if (posix_memalign((void**)&ring, DK_CACHE_LINE, sizeof(*ring)) != 0)
+    {
+        ring = NULL;
+    }
+#endif
+    if (!ring)
+    {
+        return NULL;
+    }
+
+    ring->data = malloc(g_log.ring_size);
+    if (!ring->data)
+    {
+#ifdef DK_PLATFORM_WINDOWS
+        _aligned_free(ring);
+#else
+        free(ring);
+#endif
+        return NULL;
+    }
+
+    ring->head     = 0;
+    ring->tail     = 0;
+    ring->dropped  = 0;
+    ring->capacity = g_log.ring_size;
+
+    void* head = dk_atomic_load_ptr(&g_log.rings);
+    do
+    {
+        ring->next = head;
+    } while (!dk_atomic_cas_ptr(&g_log.rings, &head, ring));
+
+    t_log_ring = ring;
+    return ring;
+}
+
+/* Copies the arguments fmt refers to into slots, returns the record size or 0 on overflow. */
+static uint32_t _dk_log_pack(uint8_t* record, const char* fmt, va_list ap)
+{
+    uint32_t size = sizeof(dk_log_record_t);
+
+#define DK_LOG_PUSH(type, value)                     \
+    do                                               \
+    {                                                \
+        type _v = (value);                           \
+        if (size + 8 > DK_LOG_RECORD_MAX)            \
+        {                                            \
+            return 0;                                \
+        }                                            \
+        memcpy(record + size, &_v, sizeof(_v));      \
+        size += DK_LOG_ALIGN((uint32_t)sizeof(_v));  \
+    } while (0)
+
+    while ((fmt = strchr(fmt, '%')))
+    {
+        dk_log_spec_t spec;
+        fmt = _dk_log_spec(fmt, &spec);
+
+        if (spec.star_width)
+        {
+            DK_LOG_PUSH(int64_t, va_arg(ap, int));
+        }
+        if (spec.star_precision)
+        {
+            int precision = va_arg(ap, int);
+            spec.precision = precision;
+            DK_LOG_PUSH(int64_t, precision);
+        }
+
+        switch (spec.conversion)
+        {
+        case 'd':
+        case 'i':
+            switch (spec.modifier)
+            {
+            case 'H': DK_LOG_PUSH(int64_t, (signed char)va_arg(ap, int)); break;
+            case 'h': DK_LOG_PUSH(int64_t, (short)va_arg(ap, int)); break;
+            case 'l': DK_LOG_PUSH(int64_t, va_arg(ap, long)); break;
+            case 'q': DK_LOG_PUSH(int64_t, va_arg(ap, long long)); break;
+            case 'j': DK_LOG_PUSH(int64_t, va_arg(ap, intmax_t)); break;
+            case 'z': DK_LOG_PUSH(int64_t, (int64_t)va_arg(ap, size_t)); break;
+            case 't': DK_LOG_PUSH(int64_t, va_arg(ap, ptrdiff_t)); break;
+            default: DK_LOG_PUSH(int64_t, va_arg(ap, int)); break;
+            }
+            break;
+        case 'o':
+        case 'u':
+        case 'x':
+        case 'X':
+            switch (spec.modifier)
+            {
+            case 'H': DK_LOG_PUSH(uint64_t, (unsigned char)va_arg(ap, unsigned int)); break;
+            case 'h': DK_LOG_PUSH(uint64_t, (unsigned short)va_arg(ap, unsigned int)); break;
+            case 'l': DK_LOG_PUSH(uint64_t, va_arg(ap, unsigned long)); break;
+            case 'q': DK_LOG_PUSH(uint64_t, va_arg(ap, unsigned long long)); break;
+            case 'j': DK_LOG_PUSH(uint64_t, va_arg(ap, uintmax_t)); break;
+            case 'z': DK_LOG_PUSH(uint64_t, va_arg(ap, size_t)); break;
+            case 't': DK_LOG_PUSH(uint64_t, (uint64_t)va_arg(ap, ptrdiff_t)); break;
+            default: DK_LOG_PUSH(uint64_t, va_arg(ap, unsigned int)); break;
+            }
+            break;
+        case 'c':
+            DK_LOG_PUSH(int64_t, va_arg(ap, int));
+            break;
+        case 'f':
+        case 'F':
+        case 'e':
+        case 'E':
+        case 'g':
+        case 'G':
+        case 'a':
+        case 'A':
+            if (spec.modifier == 'L')
+            {
+                long double value = va_arg(ap, long double);
+                if (size + DK_LOG_ALIGN((uint32_t)sizeof(value)) > DK_LOG_RECORD_MAX)
+                {
+                    return 0;
+                }
+                memcpy(record + size, &value, sizeof(value));
+                size += DK_LOG_ALIGN((uint32_t)sizeof(value));
+            }
+            else
+            {
+                DK_LOG_PUSH(double, va_arg(ap, double));
+            }
+            break;
+        case 'p':
+            DK_LOG_PUSH(const void*, va_arg(ap, void*));
+            break;
+        case 'n':
+            (void)va_arg(ap, void*); // never written back
+            break;
+        case 's':
+        {
+            const char* string = (spec.modifier == 'l') ? (va_arg(ap, void*), "(wide)") : va_arg(ap, const char*);
+            string             = string ? string : "(null)";
+
+            /* a precision bounds the read, the argument need not be terminated */
+            uint32_t limit  = (size + 8 < DK_LOG_RECORD_MAX) ? DK_LOG_RECORD_MAX - size - 8 : 0;
+            limit           = (spec.precision >= 0 && (uint32_t)spec.precision < limit) ? (uint32_t)spec.precision : limit;
+            const char* nul = memchr(string, '\0', limit);
+            uint32_t length = nul ? (uint32_t)(nul - string) : limit;
+
+            DK_LOG_PUSH(uint64_t, length);
+            memcpy(record + size, string, length);
+            size += DK_LOG_ALIGN(length);
+            break;
+        }
+        default: // %% or something we cannot size, no argument either way
+            break;
+        }
+    }
+
+#undef DK_LOG_PUSH
+
+    return size;
+}
+
+static void _dk_log_wake(void)
+{
+    dk_cond_signal(&g_log.wake);
+}
+
+static bool _dk_log_push(dk_log_ring_t* ring, const uint8_t* record, uint32_t size)
+{
+    uint64_t head       = ring->head;
+    uint32_t offset     = (uint32_t)(head & (ring->capacity - 1));
+    uint32_t contiguous = ring->capacity - offset;
+    uint32_t need       = (size > contiguous) ? contiguous + size : size;
+
+    for (;;)
+    {
+        uint64_t used = head - dk_atomic_load_u64(&ring->tail);
+        if (used + need <= ring->capacity)
+        {
+            if (used < ring->capacity / 2 && used + need >= ring->capacity / 2)
+            {
+                _dk_log_wake();
+            }
+            break;
+        }
+
+        if (g_log.policy == DK_LOG_POLICY_DROP)
+        {
+            dk_atomic_store_u64(&ring->dropped, ring->dropped + 1);
+            return false;
+        }
+
+        _dk_log_wake();
+        dk_thread_yield();
+    }
+
+    if (size > contiguous)
+    {
+        *(uint32_t*)(ring->data + offset) = 0;
+        head += contiguous;
+        offset = 0;
+    }
+
+    memcpy(ring->data + offset, record, size);
+    dk_atomic_store_u64(&ring->head, head + size);
+    return true;
+}
+
+void dk_log(int level, const char* file, int line, const char* fmt, ...)
+{
+    if (!log_enabled(level))
+    {
+        return;
+    }
+
+    va_list ap;
+    va_start(ap, fmt);
+
+    if (level >= LOG_FATAL || !dk_atomic_load_u32(&g_log.running))
+    {
+        /* fatal goes out in order and before whatever comes next can take the process down */
+        dk_log_flush();
+        log_logv(level, file, line, fmt, ap);
+    }
+    else
+    {
+        uint64_t storage[DK_LOG_RECORD_MAX / 8];
+        uint8_t* record     = (uint8_t*)storage;
+        dk_log_ring_t* ring = _dk_log_ring();
+        uint32_t size       = ring ? _dk_log_pack(record, fmt, ap) : 0;
+
+        if (size)
+        {
+            dk_log_record_t* header = (dk_log_record_t*)record;
+            header->size            = size;
+            header->level           = level;
+            header->line            = line;
+            header->reserved        = 0;
+            header->file            = file;
+            header->fmt             = fmt;
+            header->time            = dk_clock_now_ns();
+            _dk_log_push(ring, record, size);
+        }
+        else
+        {
+            va_end(ap);
+            va_start(ap, fmt);
+            log_logv(level, file, line, fmt, ap);
+        }
+    }
+
+    va_end(ap);
+}
+
+static void _dk_log_batch_flush(void)
+{
+    if (g_log.batch_size)
+    {
+        fwrite(g_log.batch, 1, g_log.batch_size, g_log.output);
+        g_log.batch_size = 0;
+    }
+}
+
+static char* _dk_log_batch_reserve(size_t size)
+{
+    if (g_log.batch_size + size > DK_LOG_BATCH_SIZE)
+    {
+        _dk_log_batch_flush();
+    }
+    return g_log.batch + g_log.batch_size;
+}
+
+static void _dk_log_batch_write(const char* string, size_t length)
+{
+    if (length > DK_LOG_BATCH_SIZE)
+    {
+        _dk_log_batch_flush();
+        fwrite(string, 1, length, g_log.output);
+        return;
+    }
+
+    memcpy(_dk_log_batch_reserve(length), string, length);
+    g_log.batch_size += length;
+}
+
+#define DK_LOG_FORMAT_MAX 4096 // single conversion, anything longer is cut
+
+static void _dk_log_batch_printf(const char* format, ...)
+{
+    char* out = _dk_log_batch_reserve(DK_LOG_FORMAT_MAX);
+
+    va_list ap;
+    va_start(ap, format);
+    int written = vsnprintf(out, DK_LOG_FORMAT_MAX, format, ap);
+    va_end(ap);
+
+    if (written > 0)
+    {
+        g_log.batch_size += (written < DK_LOG_FORMAT_MAX) ? (size_t)written : DK_LOG_FORMAT_MAX - 1;
+    }
+}
+
+/* Rebuilds one conversion with a normalized length modifier so the stored 64 bit value can
+ * be handed straight to snprintf. Returns NULL if the slots it needs run past end. */
+static const uint8_t* _dk_log_format_spec(const dk_log_spec_t* spec, const uint8_t* args, const uint8_t* end)
+{
+    char format[64];
+    size_t prefix = (size_t)(spec->length - spec->begin);
+    if (prefix > sizeof(format) - 4)
+    {
+        _dk_log_batch_write(spec->begin, (size_t)(spec->end - spec->begin));
+        return args;
+    }
+
+    memcpy(format, spec->begin, prefix);
+    char* tail = format + prefix;
+
+#define DK_LOG_NEED(bytes)                                                      \
+    do                                                                          \
+    {                                                                           \
+        if ((size_t)(end - args) < (size_t)(bytes))                             \
+            return NULL;                                                        \
+    } while (0)
+
+    DK_LOG_NEED(8 * (spec->star_width + spec->star_precision));
+
+    int64_t width     = 0;
+    int64_t precision = 0;
+    if (spec->star_width)
+    {
+        memcpy(&width, args, sizeof(width));
+        args += 8;
+    }
+    if (spec->star_precision)
+    {
+        memcpy(&precision, args, sizeof(precision));
+        args += 8;
+    }
+
+    int star[2];
+    int stars = 0;
+    if (spec->star_width)
+    {
+        star[stars++] = (int)width;
+    }
+    if (spec->star_precision && spec->conversion != 's')
+    {
+        star[stars++] = (int)precision;
+    }
+
+#define DK_LOG_EMIT(value)                                                      \
+    do                                                                          \
+    {                                                                           \
+        if (stars == 2)                                                         \
+            _dk_log_batch_printf(format, star[0], star[1], value);              \
+        else if (stars == 1)                                                    \
+            _dk_log_batch_printf(format, star[0], value);                       \
+        else                                                                    \
+            _dk_log_batch_printf(format, value);                                \
+    } while (0)
+
+    switch (spec->conversion)
+    {
+    case 'd':
+    case 'i':
+    {
+        int64_t value;
+        DK_LOG_NEED(8);
+        memcpy(&value, args, sizeof(value));
+        sprintf(tail, "ll%c", spec->conversion);
+        DK_LOG_EMIT((long long)value);
+        return args + 8;
+    }
+    case 'o':
+    case 'u':
+    case 'x':
+    case 'X':
+    {
+        uint64_t value;
+        DK_LOG_NEED(8);
+        memcpy(&value, args, sizeof(value));
+        sprintf(tail, "ll%c", spec->conversion);
+        DK_LOG_EMIT((unsigned long long)value);
+        return args + 8;
+    }
+    case 'c':
+    {
+        int64_t value;
+        DK_LOG_NEED(8);
+        memcpy(&value, args, sizeof(value));
+        sprintf(tail, "c");
+        DK_LOG_EMIT((int)value);
+        return args + 8;
+    }
+    case 'f':
+    case 'F':
+    case 'e':
+    case 'E':
+    case 'g':
+    case 'G':
+    case 'a':
+    case 'A':
+        if (spec->modifier == 'L')
+        {
+            long double value;
+            DK_LOG_NEED(DK_LOG_ALIGN((uint32_t)sizeof(value)));
+            memcpy(&value, args, sizeof(value));
+            sprintf(tail, "L%c", spec->conversion);
+            DK_LOG_EMIT(value);
+            return args + DK_LOG_ALIGN((uint32_t)sizeof(value));
+        }
+        else
+        {
+            double value;
+            DK_LOG_NEED(8);
+            memcpy(&value, args, sizeof(value));
+            sprintf(tail, "%c", spec->conversion);
+            DK_LOG_EMIT(value);
+            return args + 8;
+        }
+    case 'p':
+    {
+        const void* value;
+        DK_LOG_NEED(8);
+        memcpy(&value, args, sizeof(value));
+        sprintf(tail, "p");
+        DK_LOG_EMIT(value);
+        return args + 8;
+    }
+    case 's':
+    {
+        uint64_t length;
+        DK_LOG_NEED(8);
+        memcpy(&length, args, sizeof(length));
+        args += 8;
+        DK_LOG_NEED(length); // first, the aligned length could wrap
+        DK_LOG_NEED(DK_LOG_ALIGN((uint32_t)length));
+
+        /* copied without its terminator and already cut to any precision, so the copied
+         * length replaces the precision */
+        prefix = (size_t)(spec->dot - spec->begin);
+        sprintf(format + prefix, ".*s");
+        star[stars++] = (int)length;
+        DK_LOG_EMIT((const char*)args);
+        return args + DK_LOG_ALIGN((uint32_t)length);
+    }
+    case 'n':
+        return args;
+    case '%':
+        _dk_log_batch_write("%", 1);
+        return args;
+    default:
+        _dk_log_batch_write(spec->begin, (size_t)(spec->end - spec->begin));
+        return args;
+    }
+
+#undef DK_LOG_NEED
+#undef DK_LOG_EMIT
+}
+
+/* Writes one message in log.c's layout, the stderr one with colors or the log_add_fp one.
+ * size bounds the argument slots, formatting stops where the format wants more. */
+static void _dk_log_format(int level, const char* file, int line, const char* fmt, uint64_t time, const uint8_t* args,
+uint32_t size, bool color)
+{
+    const uint8_t* end = args + size;
+
+    int64_t seconds = g_log.wall + (int64_t)((time > g_log.origin ? time - g_log.origin : 0) / DK_NS_PER_S);
+    if (seconds != g_log.stamp_time)
+    {
+        time_t value  = (time_t)seconds;
+        struct tm* tm = localtime(&value);
+        g_log.stamp[strftime(g_log.stamp, sizeof(g_log.stamp), color ? "%H:%M:%S" : "%Y-%m-%d %H:%M:%S", tm)] = '\0';
+        g_log.stamp_time = seconds;
+    }
+
+    if (color)
+    {
+        _dk_log_batch_printf("%s %s%-5s\x1b[0m ", g_log.stamp, g_log_colors[level], log_level_string(level));
+    }
+    else
+    {
+        _dk_log_batch_printf("%s %-5s ", g_log.stamp, log_level_string(level));
+    }
+
+    const char* percent;
+    while ((percent = strchr(fmt, '%')))
+    {
+        _dk_log_batch_write(fmt, (size_t)(percent - fmt));
+
+        dk_log_spec_t spec;
+        fmt  = _dk_log_spec(percent, &spec);
+        args = _dk_log_format_spec(&spec, args, end);
+        if (!args)
+        {
+            _dk_log_batch_write("<truncated>", 11);
+            fmt = "";
+            break;
+        }
+    }
+    _dk_log_batch_write(fmt, strlen(fmt));
+
+    if (color)
+    {
+        _dk_log_batch_printf(" \x1b[90m<%s:%d>\x1b[0m\n", file, line);
+    }
+    else
+    {
+        _dk_log_batch_printf(" <%s:%d>\n", file, line);
+    }
+}
+
+static uint32_t _dk_log_site_hash(const char* fmt, const char* file, int32_t line)
+{
+    uint64_t hash = ((uint64_t)(uintptr_t)fmt * 0x9e3779b97f4a7c15ull) ^ (uint64_t)(uintptr_t)file;
+    hash          = (hash ^ (uint64_t)(uint32_t)line) * 0xff51afd7ed558ccdull;
+    return (uint32_t)(hash >> 32);
+}
+
+static dk_log_site_t* _dk_log_site_find(const char* fmt, const char* file, int32_t line)
+{
+    uint32_t mask = g_log.site_capacity - 1;
+    for (uint32_t i = _dk_log_site_hash(fmt, file, line) & mask;; i = (i + 1) & mask)
+    {
+        dk_log_site_t* site = &g_log.sites[i];
+        if (!site->id || (site->fmt == fmt && site->file == file && site->line == line))
+        {
+            return site;
+        }
+    }
+}
+
+static bool _dk_log_site_grow(void)
+{
+    dk_log_site_t* sites = g_log.sites;
+    uint32_t capacity    = g_log.site_capacity;
+
+    g_log.site_capacity = capacity ? capacity * 2 : 256;
+    g_log.sites         = calloc(g_log.site_capacity, sizeof(*g_log.sites));
+    if (!g_log.sites)
+    {
+        g_log.sites         = sites;
+        g_log.site_capacity = capacity;
+        return false;
+    }
+
+    for (uint32_t i = 0; i < capacity; i++)
+    {
+        if (sites[i].id)
+        {
+            *_dk_log_site_find(sites[i].fmt, sites[i].file, sites[i].line) = sites[i];
+        }
+    }
+    free(sites);
+    return true;
+}
+
+/* Interns the record's call site on first sight, then writes it as a binary message. */
+static void _dk_log_binary(const dk_log_record_t* record)
+{
+    if ((g_log.site_count + 1) * 2 > g_log.site_capacity && !_dk_log_site_grow())
+    {
+        g_log.site_failures++;
+        return;
+    }
+
+    dk_log_site_t* site = _dk_log_site_find(record->fmt, record->file, record->line);
+    if (!site->id)
+    {
+        site->fmt  = record->fmt;
+        site->file = record->file;
+        site->line = record->line;
+        site->id   = ++g_log.site_count;
+
+        dk_log_binary_site_t header = {
+            .tag         = 0,
+            .id          = site->id,
+            .level       = record->level,
+            .line        = record->line,
+            .file_length = (uint32_t)strlen(record->file),
+            .fmt_length  = (uint32_t)strlen(record->fmt),
+        };
+        _dk_log_batch_write((const char*)&header, sizeof(header));
+        _dk_log_batch_write(record->file, header.file_length);
+        _dk_log_batch_write(record->fmt, header.fmt_length);
+    }
+
+    dk_log_binary_message_t message = {
+        .id   = site->id,
+        .size = record->size - (uint32_t)sizeof(*record),
+        .time = record->time,
+    };
+    _dk_log_batch_write((const char*)&message, sizeof(message));
+    _dk_log_batch_write((const char*)(record + 1), message.size);
+}
+
+/* Drains every ring once, returns the number of messages formatted. */
+static uint64_t _dk_log_drain(void)
+{
+    uint64_t count = 0;
+
+    for (dk_log_ring_t* ring = dk_atomic_load_ptr(&g_log.rings); ring; ring = ring->next)
+    {
+        uint64_t tail = ring->tail;
+        uint64_t head = dk_atomic_load_u64(&ring->head);
+
+        while (tail != head)
+        {
+            uint32_t offset                = (uint32_t)(tail & (ring->capacity - 1));
+            const dk_log_record_t* record = (const dk_log_record_t*)(ring->data + offset);
+
+            if (record->size == 0)
+            {
+                tail += ring->capacity - offset;
+                continue;
+            }
+
+            if (g_log.binary)
+            {
+                _dk_log_binary(record);
+            }
+            else
+            {
+                _dk_log_format(record->level, record->file, record->line, record->fmt, record->time,
+                (const uint8_t*)(record + 1), record->size - (uint32_t)sizeof(*record), true);
+            }
+            tail += record->size;
+            count++;
+        }
+
+        dk_atomic_store_u64(&ring->tail, tail);
+    }
+
+    return count;
+}
+
+static void _dk_log_thread(void* data)
+{
+    (void)data;
+    dk_profile_thread_name("log");
+
+    for (;;)
+    {
+        dk_mutex_lock(&g_log.mutex);
+        uint64_t request = g_log.flush_request;
+        bool running     = dk_atomic_load_u32(&g_log.running) != 0;
+        dk_mutex_unlock(&g_log.mutex);
+
+        uint64_t count = _dk_log_drain();
+        if (count || request != g_log.flush_done)
+        {
+            _dk_log_batch_flush();
+            fflush(g_log.output);
+        }
+
+        dk_mutex_lock(&g_log.mutex);
+        if (request != g_log.flush_done)
+        {
+            g_log.flush_done = request;
+            dk_cond_broadcast(&g_log.flushed);
+        }
+
+        if (!running)
+        {
+            dk_mutex_unlock(&g_log.mutex);
+            break;
+        }
+
+        if (!count && g_log.flush_request == g_log.flush_done && dk_atomic_load_u32(&g_log.running))
+        {
+            dk_cond_wait_timeout(&g_log.wake, &g_log.mutex, DK_LOG_IDLE_TIMEOUT);
+        }
+        dk_mutex_unlock(&g_log.mutex);
+    }
+}
+
+void dk_log_flush(void)
+{
+    if (!dk_atomic_load_u32(&g_log.running))
+    {
+        return;
+    }
+
+    dk_mutex_lock(&g_log.mutex);
+    uint64_t ticket = ++g_log.flush_request;
+    dk_cond_signal(&g_log.wake);
+    while (g_log.flush_done < ticket && dk_atomic_load_u32(&g_log.running))
+    {
+        dk_cond_wait(&g_log.flushed, &g_log.mutex);
+    }
+    dk_mutex_unlock(&g_log.mutex);
+}
+
+uint64_t dk_log_dropped(void)
+{
+    uint64_t dropped = 0;
+    for (dk_log_ring_t* ring = dk_atomic_load_ptr(&g_log.rings); ring; ring = ring->next)
+    {
+        dropped += dk_atomic_load_u64(&ring->dropped);
+    }
+    return dropped;
+}
+
+typedef struct dk_log_decode_site {
+    char* file; // file and fmt share one allocation
+    const char* fmt;
+    int32_t level;
+    int32_t line;
+} dk_log_decode_site_t;
+
+int dk_log_decode(const char* path, FILE* output)
+{
+    DK_CHECK(path && output && !dk_atomic_load_u32(&g_log.running), DK_ERRNO_UNKNOWN);
+
+    FILE* file = fopen(path, "rb");
+    DK_CHECK(file, DK_ERRNO_UNKNOWN);
+
+    fseek(file, 0, SEEK_END);
+    long length = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    uint8_t* data = (length > 0) ? malloc((size_t)length) : NULL;
+    size_t size   = data ? fread(data, 1, (size_t)length, file) : 0;
+    fclose(file);
+
+    dk_log_binary_header_t header;
+    if (size < sizeof(header))
+    {
+        free(data);
+        DK_ERROR_HANDLE(DK_ERRNO_UNKNOWN);
+    }
+
+    memcpy(&header, data, sizeof(header));
+    if (header.magic != DK_LOG_BINARY_MAGIC || header.version != DK_LOG_BINARY_VERSION)
+    {
+        free(data);
+        DK_ERROR("log: %s is not a version %d binary log", path, DK_LOG_BINARY_VERSION);
+        return DK_ERRNO_UNKNOWN;
+    }
+
+    g_log.batch = malloc(DK_LOG_BATCH_SIZE);
+    if (!g_log.batch)
+    {
+        free(data);
+        DK_ERROR_HANDLE(DK_ERRNO_UNKNOWN);
+    }
+
+    g_log.batch_size = 0;
+    g_log.output     = output;
+    g_log.wall       = header.wall;
+    g_log.origin     = header.origin;
+    g_log.stamp_time = -1;
+
+    dk_log_decode_site_t* sites = NULL;
+    uint32_t site_count         = 0;
+    uint64_t message_count      = 0;
+    size_t offset               = sizeof(header);
+    int status                  = DK_STATUS_OK;
+
+    while (offset + sizeof(uint32_t) <= size)
+    {
+        uint32_t tag;
+        memcpy(&tag, data + offset, sizeof(tag));
+
+        if (tag == 0)
+        {
+            dk_log_binary_site_t site;
+            if (offset + sizeof(site) > size)
+            {
+                break;
+            }
+            memcpy(&site, data + offset, sizeof(site));
+            offset += sizeof(site);
+
+            if (site.id != site_count + 1 || offset + site.file_length + site.fmt_length > size ||
+            site.level < LOG_TRACE || site.level > LOG_FATAL)
+            {
+                status = DK_ERRNO_UNKNOWN;
+                break;
+            }
+
+            dk_log_decode_site_t* grown = realloc(sites, (site_count + 1) * sizeof(*sites));
+            char* strings               = malloc(site.file_length + site.fmt_length + 2);
+            if (!grown || !strings)
+            {
+                sites = grown ? grown : sites;
+                free(strings);
+                status = DK_ERRNO_UNKNOWN;
+                break;
+            }
+
+            sites                         = grown;
+            sites[site_count].file        = strings;
+            sites[site_count].fmt         = strings + site.file_length + 1;
+            sites[site_count].level       = site.level;
+            sites[site_count].line        = site.line;
+            memcpy(strings, data + offset, site.file_length);
+            strings[site.file_length] = '\0';
+            memcpy(strings + site.file_length + 1, data + offset + site.file_length, site.fmt_length);
+            strings[site.file_length + 1 + site.fmt_length] = '\0';
+
+            offset += site.file_length + site.fmt_length;
+            site_count++;
+        }
+        else
+        {
+            dk_log_binary_message_t message;
+            if (offset + sizeof(message) > size)
+            {
+                break;
+            }
+            memcpy(&message, data + offset, sizeof(message));
+            offset += sizeof(message);
+
+            if (message.id == 0 || message.id > site_count || offset + message.size > size ||
+            message.size > DK_LOG_RECORD_MAX)
+            {
+                status = DK_ERRNO_UNKNOWN;
+                break;
+            }
+
+            /* realigned so the argument slots can be walked like a ring record */
+            uint64_t args[DK_LOG_RECORD_MAX / 8];
+            memcpy(args, data + offset, message.size);
+            offset += message.size;
+
+            const dk_log_decode_site_t* site = &sites[message.id - 1];
+            _dk_log_format(
+            site->level, site->file, site->line, site->fmt, message.time, (const uint8_t*)args, message.size, false);
+            message_count++;
+        }
+    }
+
+    _dk_log_batch_flush();
+    fflush(output);
+
+    if (status != DK_STATUS_OK)
+    {
+        DK_ERROR("log: %s is corrupt after %llu messages", path, (unsigned long long)message_count);
+    }
+
+    for (uint32_t i = 0; i < site_count; i++)
+    {
+        free(sites[i].file);
+    }
+    free(sites);
+    free(g_log.batch);
+    g_log.batch = NULL;
+    free(data);
+
+    return status;
+}
+
+int _dk_log_init(dk_log_policy policy, uint32_t ring_size, const char* binary_path)
+{
+    DK_CHECK(!dk_atomic_load_u32(&g_log.running), DK_ERRNO_UNKNOWN);
+
+    uint32_t size = ring_size ? ring_size : DK_LOG_RING_SIZE;
+    DK_CHECK(size >= 2 * DK_LOG_RECORD_MAX, DK_ERRNO_UNKNOWN);
+
+    g_log.ring_size = 1;
+    while (g_log.ring_size < size)
+    {
+        g_log.ring_size <<= 1;
+    }
+
+    g_log.output = binary_path ? fopen(binary_path, "wb") : stderr;
+    DK_CHECK(g_log.output, DK_ERRNO_UNKNOWN);
+
+    g_log.batch = malloc(DK_LOG_BATCH_SIZE);
+    if (!g_log.batch)
+    {
+        if (binary_path)
+        {
+            fclose(g_log.output);
+        }
+        DK_ERROR_HANDLE(DK_ERRNO_UNKNOWN);
+    }
+
+    g_log.rings         = NULL;
+    g_log.policy        = policy;
+    g_log.flush_request = 0;
+    g_log.flush_done    = 0;
+    g_log.batch_size    = 0;
+    g_log.binary        = binary_path != NULL;
+    g_log.sites         = NULL;
+    g_log.site_capacity = 0;
+    g_log.site_count    = 0;
+    g_log.site_failures = 0;
+    g_log.wall          = (int64_t)time(NULL);
+    g_log.origin        = dk_clock_now_ns();
+    g_log.stamp_time    = -1;
+
+    if (g_log.binary)
+    {
+        dk_log_binary_header_t header = {
+            .magic   = DK_LOG_BINARY_MAGIC,
+            .version = DK_LOG_BINARY_VERSION,
+            .wall    = g_log.wall,
+            .origin  = g_log.origin,
+        };
+        _dk_log_batch_write((const char*)&header, sizeof(header));
+        DK_INFO("log: writing binary log to %s", binary_path);
+    }
+
+    dk_mutex_init(&g_log.mutex);
+    dk_cond_init(&g_log.wake);
+    dk_cond_init(&g_log.flushed);
+
+    dk_atomic_store_u32(&g_log.running, 1);
+    if (dk_thread_create(&g_log.thread, _dk_log_thread, NULL) != DK_STATUS_OK)
+    {
+        dk_atomic_store_u32(&g_log.running, 0);
+        dk_cond_destroy(&g_log.flushed);
+        dk_cond_destroy(&g_log.wake);
+        dk_mutex_destroy(&g_log.mutex);
+        if (g_log.binary)
+        {
+            fclose(g_log.output);
+        }
+        free(g_log.batch);
+        g_log.batch = NULL;
+        DK_ERROR_HANDLE(DK_ERRNO_UNKNOWN);
+    }
+
+    return DK_STATUS_OK;
+}
+
+void _dk_log_shutdown(void)
+{
+    if (!dk_atomic_load_u32(&g_log.running))
+    {
+        return;
+    }
+
+    dk_mutex_lock(&g_log.mutex);
+    dk_atomic_store_u32(&g_log.running, 0);
+    dk_cond_signal(&g_log.wake);
+    dk_cond_broadcast(&g_log.flushed);
+    dk_mutex_unlock(&g_log.mutex);
+
+    dk_thread_join(&g_log.thread);
+
+    if (g_log.binary)
+    {
+        fclose(g_log.output);
+        g_log.binary = false;
+        free(g_log.sites);
+        g_log.sites = NULL;
+        DK_INFO("log: %u call sites interned", g_log.site_count);
+        if (g_log.site_failures)
+        {
+            DK_ERROR("log: %llu messages lost, the call site table could not grow",
+            (unsigned long long)g_log.site_failures);
+        }
+    }
+    g_log.output = stderr;
+
+    uint64_t dropped = dk_log_dropped();
+    if (dropped)
+    {
+        DK_WARN("log: %llu messages dropped, rings were full", (unsigned long long)dropped);
+    }
+
+    dk_log_ring_t* ring = dk_atomic_exchange_ptr(&g_log.rings, NULL);
+    while (ring)
+    {
+        dk_log_ring_t* next = ring->next;
+        free(ring->data);
+#ifdef DK_PLATFORM_WINDOWS
+        _aligned_free(ring);
+#else
+        free(ring);
+#endif
+        ring = next;
+    }
+
+    dk_cond_destroy(&g_log.flushed);
+    dk_cond_destroy(&g_log.wake);
+    dk_mutex_destroy(&g_log.mutex);
+    free(g_log.batch);
+    g_log.batch = NULL;
+    t_log_ring  = NULL;
+}
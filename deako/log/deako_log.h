@@ -0,0 +1,42 @@
+#ifndef DEAKO_LOG_H
+#define DEAKO_LOG_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/* What a producer does when its ring is full. */
+typedef enum dk_log_policy {
+    DK_LOG_POLICY_DROP = 0, // count and discard the message
+    DK_LOG_POLICY_BLOCK,    // wait for the log thread to make room
+} dk_log_policy;
+
+/* Front end for DK_TRACE..DK_FATAL. Until _dk_log_init starts the log thread, and after
+ * _dk_log_shutdown, messages go straight through log.c on the calling thread. While it
+ * runs, each thread copies the format pointer and its raw arguments into its own ring and
+ * the log thread formats and writes them to stderr in batches. Callbacks registered with
+ * log_add_callback only see synchronous messages.
+ *
+ * The format string and file must outlive the log thread, string literals are assumed;
+ * %s arguments are copied. FATAL flushes the queue and is written synchronously, to stderr
+ * even in binary mode. */
+extern void dk_log(int level, const char* file, int line, const char* fmt, ...);
+
+/* Blocks until every message queued before the call has been written. */
+extern void dk_log_flush(void);
+
+extern uint64_t dk_log_dropped(void);
+
+/* Turns a binary log back into text in log.c's file layout. The log must come from a build
+ * for the same platform, argument slots are stored in native layout. */
+extern int dk_log_decode(const char* path, FILE* output);
+
+/* ring_size in bytes per logging thread, 0 = 64 KiB. With a binary_path the log thread
+ * writes the binary log there instead of formatting text to stderr. */
+extern int _dk_log_init(dk_log_policy policy, uint32_t ring_size, const char* binary_path);
+
+/* Flushes and stops the log thread, every other thread must have stopped logging. */
+extern void _dk_log_shutdown(void);
+
+#endif // DEAKO_LOG_H
@@ -0,0 +1,396 @@
+#include "deako_pch.h"
+#include "deako_arena.h"
+
+#include "platform/deako_atomic.h"
+#include "platform/deako_vm.h"
+
+#include <malloc.h>
+#include <string.h>
+
+#define DK_ARENA_COMMIT_SIZE (64ull * 1024) // commit granularity of virtual arenas
+
+static dk_arena_stats_t g_arena_stats[DK_ARENA_STATS_MAX];
+static volatile uint32_t g_arena_stats_count = 0;
+static volatile uint32_t g_arena_stats_lock  = 0; // registration only, allocations never take it
+
+static uint64_t _dk_arena_align(uint64_t address, uint64_t align)
+{
+    return (address + align - 1) & ~(align - 1);
+}
+
+static uint64_t _dk_arena_granule(const dk_arena_t* arena)
+{
+    return (arena->flags & DK_ARENA_FLAG_HUGE_PAGES) ? DK_VM_HUGE_PAGE_SIZE : DK_ARENA_COMMIT_SIZE;
+}
+
+static uint64_t _dk_arena_limit(const dk_arena_t* arena)
+{
+    return (arena->flags & DK_ARENA_FLAG_VIRTUAL) ? arena->reserved : arena->capacity;
+}
+
+/* Grows a virtual arena's committed range to cover end. Allocations race here from
+ * dk_arena_alloc_atomic, the lock only guards the commit itself. */
+static bool _dk_arena_commit(dk_arena_t* arena, uint64_t end)
+{
+    if (end <= dk_atomic_load_u64(&arena->capacity))
+    {
+        return true;
+    }
+    if (!(arena->flags & DK_ARENA_FLAG_VIRTUAL) || end > arena->reserved)
+    {
+        return false;
+    }
+
+    uint32_t expected = 0;
+    while (!dk_atomic_cas_u32(&arena->commit_lock, &expected, 1))
+    {
+        expected = 0;
+        dk_atomic_pause();
+    }
+
+    bool committed    = true;
+    uint64_t capacity = arena->capacity;
+    if (end > capacity)
+    {
+        uint64_t target = _dk_arena_align(end, _dk_arena_granule(arena));
+        target          = (target < arena->reserved) ? target : arena->reserved;
+        committed       = dk_vm_commit(arena->base + capacity, target - capacity);
+        if (committed)
+        {
+            dk_atomic_store_u64(&arena->capacity, target);
+        }
+    }
+
+    dk_atomic_store_u32(&arena->commit_lock, 0);
+    return committed;
+}
+
+static void _dk_arena_stats_alloc(dk_arena_stats_t* stats, uint64_t bytes)
+{
+    uint64_t live = dk_atomic_add_u64(&stats->live, bytes) + bytes;
+    dk_atomic_add_u64(&stats->allocs, 1);
+    dk_atomic_add_u64(&stats->bytes, bytes);
+    dk_atomic_add_u64(&stats->frame_allocs, 1);
+    dk_atomic_add_u64(&stats->frame_bytes, bytes);
+
+    uint64_t peak = dk_atomic_load_u64(&stats->peak);
+    while (live > peak && !dk_atomic_cas_u64(&stats->peak, &peak, live))
+    {
+    }
+}
+
+static void _dk_arena_stats_release(dk_arena_stats_t* stats, uint64_t bytes)
+{
+    dk_atomic_add_u64(&stats->live, (uint64_t)0 - bytes);
+}
+
+int dk_arena_init(dk_arena_t* arena, uint64_t capacity)
+{
+    DK_CHECK(arena && capacity, DK_ERRNO_UNKNOWN);
+
+    void* base = malloc(capacity);
+    DK_CHECK(base, DK_ERRNO_UNKNOWN);
+
+    dk_arena_init_buffer(arena, base, capacity);
+    arena->flags = DK_ARENA_FLAG_OWNED;
+
+    return DK_STATUS_OK;
+}
+
+int dk_arena_init_virtual(dk_arena_t* arena, uint64_t reserve, uint32_t flags)
+{
+    DK_CHECK(arena && reserve, DK_ERRNO_UNKNOWN);
+
+    dk_arena_init_buffer(arena, NULL, 0);
+    arena->flags = flags | DK_ARENA_FLAG_VIRTUAL;
+    reserve      = _dk_arena_align(reserve, _dk_arena_granule(arena));
+
+    arena->base = dk_vm_reserve(reserve, (flags & DK_ARENA_FLAG_HUGE_PAGES) != 0);
+    if (!arena->base)
+    {
+        arena->flags = 0;
+        DK_ERROR_HANDLE(DK_ERRNO_UNKNOWN);
+    }
+
+    arena->reserved = reserve;
+
+    return DK_STATUS_OK;
+}
+
+void dk_arena_init_buffer(dk_arena_t* arena, void* buffer, uint64_t capacity)
+{
+    arena->base        = buffer;
+    arena->offset      = 0;
+    arena->capacity    = buffer ? capacity : 0;
+    arena->reserved    = 0;
+    arena->high_water  = 0;
+    arena->flags       = DK_ARENA_FLAG_NONE;
+    arena->commit_lock = 0;
+    arena->stats       = NULL;
+}
+
+void dk_arena_shutdown(dk_arena_t* arena)
+{
+    if (arena->stats)
+    {
+        _dk_arena_stats_release(arena->stats, arena->offset);
+        dk_atomic_add_u32(&arena->stats->arenas, (uint32_t)-1);
+    }
+
+    if (arena->flags & DK_ARENA_FLAG_VIRTUAL)
+    {
+        dk_vm_release(arena->base, arena->reserved);
+    }
+    else if (arena->flags & DK_ARENA_FLAG_OWNED)
+    {
+        free(arena->base);
+    }
+
+    dk_arena_init_buffer(arena, NULL, 0);
+}
+
+void* dk_arena_alloc(dk_arena_t* arena, uint64_t size, uint64_t align)
+{
+    uint64_t address = (uint64_t)(uintptr_t)arena->base;
+    uint64_t begin   = _dk_arena_align(address + arena->offset, align) - address;
+
+    if (begin + size > _dk_arena_limit(arena) || begin + size < begin || !_dk_arena_commit(arena, begin + size))
+    {
+        return NULL;
+    }
+
+    if (arena->stats)
+    {
+        _dk_arena_stats_alloc(arena->stats, begin + size - arena->offset);
+    }
+
+    arena->offset = begin + size;
+    return arena->base + begin;
+}
+
+void* dk_arena_alloc_atomic(dk_arena_t* arena, uint64_t size, uint64_t align)
+{
+    uint64_t address = (uint64_t)(uintptr_t)arena->base;
+    uint64_t offset  = dk_atomic_load_u64(&arena->offset);
+    uint64_t begin;
+
+    do
+    {
+        begin = _dk_arena_align(address + offset, align) - address;
+        if (begin + size > _dk_arena_limit(arena) || begin + size < begin)
+        {
+            return NULL;
+        }
+    } while (!dk_atomic_cas_u64(&arena->offset, &offset, begin + size));
+
+    /* the range is ours already, failing to back it only wastes it until the next reset */
+    if (!_dk_arena_commit(arena, begin + size))
+    {
+        return NULL;
+    }
+
+    if (arena->stats)
+    {
+        _dk_arena_stats_alloc(arena->stats, begin + size - offset);
+    }
+
+    return arena->base + begin;
+}
+
+void dk_arena_reset(dk_arena_t* arena)
+{
+    if (arena->stats)
+    {
+        _dk_arena_stats_release(arena->stats, arena->offset);
+    }
+
+    arena->high_water = dk_arena_high_water(arena);
+    arena->offset     = 0;
+
+    /* keep the first granule so a steady small user does not fault on every reset */
+    uint64_t keep = _dk_arena_granule(arena);
+    if ((arena->flags & DK_ARENA_FLAG_DECOMMIT) && arena->capacity > keep)
+    {
+        dk_vm_decommit(arena->base + keep, arena->capacity - keep);
+        arena->capacity = keep;
+    }
+}
+
+void dk_arena_rewind(dk_arena_t* arena, uint64_t offset)
+{
+    if (offset >= arena->offset)
+    {
+        return;
+    }
+
+    if (arena->stats)
+    {
+        _dk_arena_stats_release(arena->stats, arena->offset - offset);
+    }
+
+    arena->high_water = dk_arena_high_water(arena);
+    arena->offset     = offset;
+}
+
+uint64_t dk_arena_high_water(const dk_arena_t* arena)
+{
+    return (arena->offset > arena->high_water) ? arena->offset : arena->high_water;
+}
+
+static void _dk_arena_stats_lock(void)
+{
+    uint32_t expected = 0;
+    while (!dk_atomic_cas_u32(&g_arena_stats_lock, &expected, 1))
+    {
+        expected = 0;
+        dk_atomic_pause();
+    }
+}
+
+static void _dk_arena_stats_unlock(void)
+{
+    dk_atomic_store_u32(&g_arena_stats_lock, 0);
+}
+
+/* caller holds the lock */
+static dk_arena_stats_t* _dk_arena_stats_get(const char* name)
+{
+    uint32_t count = g_arena_stats_count;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        if (strcmp(g_arena_stats[i].name, name) == 0)
+        {
+            return &g_arena_stats[i];
+        }
+    }
+
+    if (count == DK_ARENA_STATS_MAX)
+    {
+        return NULL;
+    }
+
+    dk_arena_stats_t* stats = &g_arena_stats[count];
+    memset(stats, 0, sizeof(*stats));
+    stats->name = name;
+    dk_atomic_store_u32(&g_arena_stats_count, count + 1);
+    return stats;
+}
+
+dk_arena_stats_t* dk_arena_track(dk_arena_t* arena, const char* name)
+{
+    if (!arena || !name || arena->stats)
+    {
+        return NULL;
+    }
+
+    _dk_arena_stats_lock();
+    dk_arena_stats_t* stats = _dk_arena_stats_get(name);
+    _dk_arena_stats_unlock();
+
+    if (!stats)
+    {
+        DK_WARN("memory: more than %d tracked names, %s is not accounted", DK_ARENA_STATS_MAX, name);
+        return NULL;
+    }
+
+    dk_atomic_add_u32(&stats->arenas, 1);
+    if (arena->offset)
+    {
+        _dk_arena_stats_alloc(stats, arena->offset);
+    }
+    arena->stats = stats;
+
+    return stats;
+}
+
+void dk_memory_set_budget(const char* name, uint64_t budget)
+{
+    _dk_arena_stats_lock();
+    dk_arena_stats_t* stats = _dk_arena_stats_get(name);
+    _dk_arena_stats_unlock();
+
+    if (stats)
+    {
+        stats->budget = budget;
+    }
+}
+
+uint32_t dk_memory_stats_count(void)
+{
+    return dk_atomic_load_u32(&g_arena_stats_count);
+}
+
+int dk_memory_stats(uint32_t index, dk_memory_stats_t* out)
+{
+    DK_CHECK(out && index < dk_memory_stats_count(), DK_ERRNO_UNKNOWN);
+
+    const dk_arena_stats_t* stats = &g_arena_stats[index];
+    uint64_t frames               = stats->frames ? stats->frames : 1;
+
+    out->name             = stats->name;
+    out->live             = dk_atomic_load_u64(&stats->live);
+    out->peak             = dk_atomic_load_u64(&stats->peak);
+    out->allocs           = dk_atomic_load_u64(&stats->allocs);
+    out->budget           = stats->budget;
+    out->allocs_per_frame = (double)out->allocs / (double)frames;
+    out->bytes_per_frame  = (double)dk_atomic_load_u64(&stats->bytes) / (double)frames;
+    out->frame_allocs_max = stats->frame_allocs_max;
+    out->frame_bytes_max  = stats->frame_bytes_max;
+
+    return DK_STATUS_OK;
+}
+
+int dk_memory_stats_find(const char* name, dk_memory_stats_t* out)
+{
+    uint32_t count = dk_memory_stats_count();
+    for (uint32_t i = 0; name && i < count; i++)
+    {
+        if (strcmp(g_arena_stats[i].name, name) == 0)
+        {
+            return dk_memory_stats(i, out);
+        }
+    }
+
+    return DK_ERRNO_UNKNOWN;
+}
+
+void _dk_arena_stats_frame(void)
+{
+    uint32_t count = dk_memory_stats_count();
+    for (uint32_t i = 0; i < count; i++)
+    {
+        dk_arena_stats_t* stats = &g_arena_stats[i];
+        uint64_t allocs         = dk_atomic_exchange_u64(&stats->frame_allocs, 0);
+        uint64_t bytes          = dk_atomic_exchange_u64(&stats->frame_bytes, 0);
+
+        stats->frame_allocs_max = (allocs > stats->frame_allocs_max) ? allocs : stats->frame_allocs_max;
+        stats->frame_bytes_max  = (bytes > stats->frame_bytes_max) ? bytes : stats->frame_bytes_max;
+        stats->frames++;
+    }
+}
+
+void _dk_arena_stats_report(void)
+{
+    uint32_t count = dk_memory_stats_count();
+    for (uint32_t i = 0; i < count; i++)
+    {
+        dk_memory_stats_t stats;
+        dk_memory_stats(i, &stats);
+
+        DK_INFO("memory %s: peak %.1f KiB, %llu allocs, %.1f allocs/frame (max %llu, %.1f KiB)", stats.name,
+        (double)stats.peak / 1024, (unsigned long long)stats.allocs, stats.allocs_per_frame,
+        (unsigned long long)stats.frame_allocs_max, (double)stats.frame_bytes_max / 1024);
+
+        if (stats.live || g_arena_stats[i].arenas)
+        {
+            DK_WARN("memory %s: %.1f KiB in %u arenas never reset or shut down", stats.name, (double)stats.live / 1024,
+            g_arena_stats[i].arenas);
+        }
+
+        if (stats.budget && stats.peak > stats.budget)
+        {
+            DK_WARN("memory %s: peak %.1f KiB is over its %.1f KiB budget", stats.name, (double)stats.peak / 1024,
+            (double)stats.budget / 1024);
+        }
+    }
+}
@@ -0,0 +1,95 @@
+#ifndef DEAKO_ARENA_H
+#define DEAKO_ARENA_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define DK_ARENA_ALIGN 16 // default alignment, enough for any scalar or SSE type
+#define DK_ARENA_STATS_MAX 64
+
+/* Accounting shared by every arena tracked under one name, updated atomically since frame
+ * arenas are allocated from concurrently. */
+typedef struct dk_arena_stats {
+    const char* name;
+    volatile uint64_t live; // bytes, alignment padding included
+    volatile uint64_t peak;
+    volatile uint64_t allocs;
+    volatile uint64_t bytes;        // ever allocated
+    volatile uint64_t frame_allocs; // since the last _dk_arena_stats_frame
+    volatile uint64_t frame_bytes;
+    uint64_t frame_allocs_max;
+    uint64_t frame_bytes_max;
+    uint64_t frames;
+    uint64_t budget; // bytes, 0 = none
+    volatile uint32_t arenas; // tracked and not yet shut down
+} dk_arena_stats_t;
+
+/* plain copy for queries */
+typedef struct dk_memory_stats {
+    const char* name;
+    uint64_t live;
+    uint64_t peak;
+    uint64_t allocs;
+    uint64_t budget;
+    double allocs_per_frame; // mean since startup
+    double bytes_per_frame;
+    uint64_t frame_allocs_max;
+    uint64_t frame_bytes_max;
+} dk_memory_stats_t;
+
+typedef enum dk_arena_flag {
+    DK_ARENA_FLAG_NONE       = 0,
+    DK_ARENA_FLAG_OWNED      = 1 << 0, // base is freed by dk_arena_shutdown
+    DK_ARENA_FLAG_VIRTUAL    = 1 << 1, // reserved address space, committed as it fills
+    DK_ARENA_FLAG_HUGE_PAGES = 1 << 2, // virtual only, transparent huge pages where supported
+    DK_ARENA_FLAG_DECOMMIT   = 1 << 3, // virtual only, reset hands committed pages back to the OS
+} dk_arena_flag;
+
+/* Linear allocator over one contiguous block. Allocations are only ever released all at
+ * once by dk_arena_reset. A zeroed arena is valid and empty, every allocation from it
+ * fails until it is given memory. Virtual arenas never move: they reserve their whole range
+ * up front and grow capacity in place. */
+typedef struct dk_arena {
+    uint8_t* base;
+    volatile uint64_t offset;   // bytes in use
+    volatile uint64_t capacity; // usable now, committed bytes for virtual arenas
+    uint64_t reserved;          // virtual arenas, the most capacity can grow to
+    uint64_t high_water;        // largest offset seen before a reset
+    uint32_t flags;             // dk_arena_flag
+    volatile uint32_t commit_lock;
+    dk_arena_stats_t* stats; // NULL unless tracked
+} dk_arena_t;
+
+extern int dk_arena_init(dk_arena_t* arena, uint64_t capacity);
+extern int dk_arena_init_virtual(dk_arena_t* arena, uint64_t reserve, uint32_t flags);
+extern void dk_arena_init_buffer(dk_arena_t* arena, void* buffer, uint64_t capacity);
+extern void dk_arena_shutdown(dk_arena_t* arena);
+
+/* align must be a power of two, NULL when the arena is full */
+extern void* dk_arena_alloc(dk_arena_t* arena, uint64_t size, uint64_t align);
+
+/* same, safe to call from several threads at once on the same arena */
+extern void* dk_arena_alloc_atomic(dk_arena_t* arena, uint64_t size, uint64_t align);
+
+extern void dk_arena_reset(dk_arena_t* arena);
+
+/* releases everything allocated after offset, a value of arena->offset read earlier */
+extern void dk_arena_rewind(dk_arena_t* arena, uint64_t offset);
+extern uint64_t dk_arena_high_water(const dk_arena_t* arena);
+
+/* Accounts the arena under name, arenas with the same name share one entry. Call after
+ * init; shutdown and re-init untrack it. NULL once DK_ARENA_STATS_MAX names are in use. */
+extern dk_arena_stats_t* dk_arena_track(dk_arena_t* arena, const char* name);
+extern void dk_memory_set_budget(const char* name, uint64_t budget);
+
+extern uint32_t dk_memory_stats_count(void);
+extern int dk_memory_stats(uint32_t index, dk_memory_stats_t* stats);
+extern int dk_memory_stats_find(const char* name, dk_memory_stats_t* stats);
+
+/* closes the per-frame counters, once per frame on the main thread */
+extern void _dk_arena_stats_frame(void);
+
+/* per name usage, then anything still live or over budget */
+extern void _dk_arena_stats_report(void);
+
+#endif // DEAKO_ARENA_H
@@ -0,0 +1,196 @@
+#include "deako_pch.h"
+#include "deako_handle_pool.h"
+
+#include <malloc.h>
+#include <string.h>
+
+static int _dk_handle_pool_grow(dk_handle_pool_t* pool)
+{
+    uint32_t capacity = pool->capacity ? pool->capacity * 2 : 64;
+    DK_CHECK(capacity > pool->capacity && capacity < DK_HANDLE_NONE, DK_ERRNO_UNKNOWN);
+
+    /* realloc one array at a time, a failure leaves the pool as it was at its old capacity */
+    uint32_t* generations = realloc(pool->generations, capacity * sizeof(*generations));
+    DK_CHECK(generations, DK_ERRNO_UNKNOWN);
+    pool->generations = generations;
+
+    uint32_t* dense = realloc(pool->dense, capacity * sizeof(*dense));
+    DK_CHECK(dense, DK_ERRNO_UNKNOWN);
+    pool->dense = dense;
+
+    uint8_t* flags = realloc(pool->flags, capacity * sizeof(*flags));
+    DK_CHECK(flags, DK_ERRNO_UNKNOWN);
+    pool->flags = flags;
+
+    uint32_t* slots = realloc(pool->slots, capacity * sizeof(*slots));
+    DK_CHECK(slots, DK_ERRNO_UNKNOWN);
+    pool->slots = slots;
+
+    uint8_t* data = realloc(pool->data, (size_t)capacity * pool->element_size);
+    DK_CHECK(data, DK_ERRNO_UNKNOWN);
+    pool->data = data;
+
+    /* new slots are chained in index order ahead of whatever was free */
+    for (uint32_t i = pool->capacity; i < capacity; i++)
+    {
+        generations[i] = 0;
+        flags[i]       = 0;
+        dense[i]       = (i + 1 < capacity) ? i + 1 : pool->free_head;
+    }
+
+    pool->free_head = pool->capacity;
+    pool->capacity  = capacity;
+
+    return DK_STATUS_OK;
+}
+
+int dk_handle_pool_init(dk_handle_pool_t* pool, dk_handle_type type, uint32_t element_size, uint32_t capacity)
+{
+    DK_CHECK(pool && element_size && type < DK_HANDLE_TYPE_COUNT, DK_ERRNO_UNKNOWN);
+
+    memset(pool, 0, sizeof(*pool));
+    pool->type         = type;
+    pool->element_size = element_size;
+    pool->free_head    = DK_HANDLE_NONE;
+
+    while (pool->capacity < capacity)
+    {
+        int status = _dk_handle_pool_grow(pool);
+        if (status != DK_STATUS_OK)
+        {
+            dk_handle_pool_shutdown(pool);
+            return status;
+        }
+    }
+
+    return DK_STATUS_OK;
+}
+
+void dk_handle_pool_shutdown(dk_handle_pool_t* pool)
+{
+    if (pool->count)
+    {
+        DK_WARN("handle pool %d: %u handles still live at shutdown", (int)pool->type, pool->count);
+    }
+
+    free(pool->generations);
+    free(pool->dense);
+    free(pool->flags);
+    free(pool->slots);
+    free(pool->data);
+    memset(pool, 0, sizeof(*pool));
+    pool->free_head = DK_HANDLE_NONE;
+}
+
+/* slot of a live handle from this pool, DK_HANDLE_NONE otherwise */
+static uint32_t _dk_handle_slot(const dk_handle_pool_t* pool, dk_handle_t handle)
+{
+    if (handle.type != pool->type || handle.index >= pool->capacity || !(handle.generation & 1) ||
+    pool->generations[handle.index] != handle.generation)
+    {
+        return DK_HANDLE_NONE;
+    }
+
+    return handle.index;
+}
+
+dk_handle_t dk_handle_alloc(dk_handle_pool_t* pool, uint32_t flags)
+{
+    dk_handle_t handle = { .type = pool->type, .index = 0, .generation = 0 };
+
+    if (pool->free_head == DK_HANDLE_NONE && _dk_handle_pool_grow(pool) != DK_STATUS_OK)
+    {
+        return handle;
+    }
+
+    uint32_t slot   = pool->free_head;
+    pool->free_head = pool->dense[slot];
+
+    uint32_t element = pool->count++;
+
+    pool->dense[slot]    = element;
+    pool->slots[element] = slot;
+    pool->flags[slot]    = (uint8_t)(flags | DK_HANDLE_FLAG_ACTIVE);
+    pool->generations[slot]++; // even to odd, live
+    memset(pool->data + (size_t)element * pool->element_size, 0, pool->element_size);
+
+    handle.index      = slot;
+    handle.generation = pool->generations[slot];
+    return handle;
+}
+
+bool dk_handle_free(dk_handle_pool_t* pool, dk_handle_t handle)
+{
+    uint32_t slot = _dk_handle_slot(pool, handle);
+    if (slot == DK_HANDLE_NONE)
+    {
+        return false;
+    }
+
+    /* keep the data dense, the last element takes over the hole */
+    uint32_t element = pool->dense[slot];
+    uint32_t last    = --pool->count;
+    if (element != last)
+    {
+        size_t size = pool->element_size;
+        memcpy(pool->data + element * size, pool->data + last * size, size);
+        pool->slots[element]              = pool->slots[last];
+        pool->dense[pool->slots[element]] = element;
+    }
+
+    pool->generations[slot]++; // odd to even, stale
+    pool->flags[slot] = 0;
+    pool->dense[slot] = pool->free_head;
+    pool->free_head   = slot;
+
+    return true;
+}
+
+void* dk_handle_get(const dk_handle_pool_t* pool, dk_handle_t handle)
+{
+    uint32_t slot = _dk_handle_slot(pool, handle);
+    return (slot != DK_HANDLE_NONE) ? pool->data + (size_t)pool->dense[slot] * pool->element_size : NULL;
+}
+
+bool dk_handle_valid(const dk_handle_pool_t* pool, dk_handle_t handle)
+{
+    return _dk_handle_slot(pool, handle) != DK_HANDLE_NONE;
+}
+
+uint32_t dk_handle_flags(const dk_handle_pool_t* pool, dk_handle_t handle)
+{
+    uint32_t slot = _dk_handle_slot(pool, handle);
+    return (slot != DK_HANDLE_NONE) ? pool->flags[slot] : 0;
+}
+
+bool dk_handle_set_flags(dk_handle_pool_t* pool, dk_handle_t handle, uint32_t flags)
+{
+    uint32_t slot = _dk_handle_slot(pool, handle);
+    if (slot == DK_HANDLE_NONE)
+    {
+        return false;
+    }
+
+    pool->flags[slot] = (uint8_t)(flags | DK_HANDLE_FLAG_ACTIVE);
+    return true;
+}
+
+void* dk_handle_pool_data(const dk_handle_pool_t* pool, uint32_t* count)
+{
+    if (count)
+    {
+        *count = pool->count;
+    }
+    return pool->data;
+}
+
+dk_handle_t dk_handle_at(const dk_handle_pool_t* pool, uint32_t element)
+{
+    dk_handle_t handle = { .type = pool->type, .index = 0, .generation = 0 };
+    if (element < pool->count)
+    {
+        handle.index      = pool->slots[element];
+        handle.generation = pool->generations[handle.index];
+    }
+    return handle;
+}
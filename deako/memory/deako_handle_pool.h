@@ -0,0 +1,48 @@
+#ifndef DEAKO_HANDLE_POOL_H
+#define DEAKO_HANDLE_POOL_H
+
+#include "deako_internal.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define DK_HANDLE_NONE UINT32_MAX
+
+/* Generational pool of fixed-size elements addressed by dk_handle_t. Slots are kept as
+ * parallel arrays and freed slots are chained through their dense entry, so alloc and free
+ * are O(1). Element data is packed densely, a free moves the last element into the hole:
+ * pointers from dk_handle_get are only good until the next alloc or free, handles are
+ * stable. Not thread safe. */
+typedef struct dk_handle_pool {
+    dk_handle_type type;
+    uint32_t element_size;
+    uint32_t capacity;
+    uint32_t count;        // live elements, data[0, count)
+    uint32_t free_head;    // DK_HANDLE_NONE when every slot is taken
+    uint32_t* generations; // per slot, odd while live
+    uint32_t* dense;       // per slot, data index while live, next free slot otherwise
+    uint8_t* flags;        // per slot, dk_handle_flag
+    uint32_t* slots;       // per element, the slot it belongs to
+    uint8_t* data;
+} dk_handle_pool_t;
+
+/* type is stamped on every handle the pool issues, a handle of another type is foreign. */
+extern int dk_handle_pool_init(dk_handle_pool_t* pool, dk_handle_type type, uint32_t element_size, uint32_t capacity);
+extern void dk_handle_pool_shutdown(dk_handle_pool_t* pool);
+
+/* Zeroed element and DK_HANDLE_FLAG_ACTIVE added to flags, a null handle when out of memory. */
+extern dk_handle_t dk_handle_alloc(dk_handle_pool_t* pool, uint32_t flags);
+extern bool dk_handle_free(dk_handle_pool_t* pool, dk_handle_t handle);
+
+/* NULL for null, stale or foreign handles */
+extern void* dk_handle_get(const dk_handle_pool_t* pool, dk_handle_t handle);
+extern bool dk_handle_valid(const dk_handle_pool_t* pool, dk_handle_t handle);
+
+extern uint32_t dk_handle_flags(const dk_handle_pool_t* pool, dk_handle_t handle);
+extern bool dk_handle_set_flags(dk_handle_pool_t* pool, dk_handle_t handle, uint32_t flags);
+
+/* Dense iteration: elements [0, count) back to back, dk_handle_at gives each one's handle. */
+extern void* dk_handle_pool_data(const dk_handle_pool_t* pool, uint32_t* count);
+extern dk_handle_t dk_handle_at(const dk_handle_pool_t* pool, uint32_t element);
+
+#endif // DEAKO_HANDLE_POOL_H
@@ -0,0 +1,207 @@
+#include "deako_pch.h"
+#include "deako_pool.h"
+
+#include "platform/deako_atomic.h"
+
+#include <string.h>
+
+/* A free block holds two links in its first 8 bytes: [0] the next block of its chain,
+ * [1] the next chain, only meaningful on the first block of a chain in the shared stack. */
+typedef struct dk_pool_cache {
+    uint32_t generation; // of the pool this entry was filled from, 0 = never
+    uint32_t head;       // chained through link [0]
+    uint32_t count;
+} dk_pool_cache_t;
+
+static void* volatile g_pool_slots[DK_POOL_MAX];
+static volatile uint32_t g_pool_generation = 0;
+static DK_THREAD_LOCAL dk_pool_cache_t t_pool_caches[DK_POOL_MAX];
+
+static uint32_t* _dk_pool_block(const dk_pool_t* pool, uint32_t index)
+{
+    return (uint32_t*)(pool->arena->base + (uint64_t)index * DK_POOL_UNIT);
+}
+
+static uint64_t _dk_pool_tag(uint64_t head)
+{
+    return ((head >> 32) + 1) << 32;
+}
+
+static dk_pool_cache_t* _dk_pool_cache(const dk_pool_t* pool)
+{
+    dk_pool_cache_t* cache = &t_pool_caches[pool->slot];
+    if (cache->generation != pool->generation)
+    {
+        cache->generation = pool->generation;
+        cache->head       = DK_POOL_NONE;
+        cache->count      = 0;
+    }
+    return cache;
+}
+
+static void _dk_pool_push(dk_pool_t* pool, uint32_t first)
+{
+    uint32_t* block = _dk_pool_block(pool, first);
+    uint64_t head   = dk_atomic_load_u64(&pool->head);
+    do
+    {
+        dk_atomic_store_u32(&block[1], (uint32_t)head);
+    } while (!dk_atomic_cas_u64(&pool->head, &head, _dk_pool_tag(head) | first));
+}
+
+static uint32_t _dk_pool_pop(dk_pool_t* pool)
+{
+    uint64_t head = dk_atomic_load_u64(&pool->head);
+    for (;;)
+    {
+        uint32_t first = (uint32_t)head;
+        if (first == DK_POOL_NONE)
+        {
+            return DK_POOL_NONE;
+        }
+
+        /* may read a block another thread has popped and reused since, the tag then fails
+         * the CAS before the stale link is used */
+        uint32_t next = dk_atomic_load_u32(&_dk_pool_block(pool, first)[1]);
+        if (dk_atomic_cas_u64(&pool->head, &head, _dk_pool_tag(head) | next))
+        {
+            return first;
+        }
+    }
+}
+
+static bool _dk_pool_refill(dk_pool_t* pool, dk_pool_cache_t* cache)
+{
+    uint32_t first = _dk_pool_pop(pool);
+    if (first != DK_POOL_NONE)
+    {
+        uint32_t count = 0;
+        for (uint32_t index = first; index != DK_POOL_NONE; index = _dk_pool_block(pool, index)[0])
+        {
+            count++;
+        }
+
+        cache->head  = first;
+        cache->count = count;
+        return true;
+    }
+
+    uint64_t size   = (uint64_t)pool->block_size * DK_POOL_CHAIN;
+    uint8_t* memory = dk_arena_alloc_atomic(pool->arena, size, pool->align);
+    if (!memory)
+    {
+        return false;
+    }
+
+    uint32_t base   = (uint32_t)((uint64_t)(memory - pool->arena->base) / DK_POOL_UNIT);
+    uint32_t stride = pool->block_size / DK_POOL_UNIT;
+    for (uint32_t i = 0; i < DK_POOL_CHAIN; i++)
+    {
+        uint32_t* block = (uint32_t*)(memory + (uint64_t)i * pool->block_size);
+        block[0]        = (i + 1 < DK_POOL_CHAIN) ? base + (i + 1) * stride : DK_POOL_NONE;
+    }
+
+    dk_atomic_add_u64(&pool->carved, DK_POOL_CHAIN);
+    cache->head  = base;
+    cache->count = DK_POOL_CHAIN;
+    return true;
+}
+
+/* moves the first DK_POOL_CHAIN cached blocks to the shared stack as one chain */
+static void _dk_pool_flush(dk_pool_t* pool, dk_pool_cache_t* cache)
+{
+    uint32_t first = cache->head;
+    uint32_t* last = _dk_pool_block(pool, first);
+    for (uint32_t i = 1; i < DK_POOL_CHAIN; i++)
+    {
+        last = _dk_pool_block(pool, last[0]);
+    }
+
+    cache->head = last[0];
+    cache->count -= DK_POOL_CHAIN;
+    last[0] = DK_POOL_NONE;
+
+    _dk_pool_push(pool, first);
+}
+
+int dk_pool_init(dk_pool_t* pool, dk_arena_t* arena, uint32_t block_size, uint32_t align)
+{
+    DK_CHECK(pool && arena && arena->base && block_size, DK_ERRNO_UNKNOWN);
+    DK_CHECK(align && (align & (align - 1)) == 0, DK_ERRNO_UNKNOWN);
+
+    uint64_t limit = (arena->flags & DK_ARENA_FLAG_VIRTUAL) ? arena->reserved : arena->capacity;
+    DK_CHECK(limit / DK_POOL_UNIT < DK_POOL_NONE, DK_ERRNO_UNKNOWN); // indices must fit 32 bits
+
+    align = (align > DK_POOL_UNIT) ? align : DK_POOL_UNIT;
+
+    pool->head       = DK_POOL_NONE;
+    pool->arena      = arena;
+    pool->block_size = (block_size + align - 1) & ~(align - 1);
+    pool->align      = align;
+    pool->slot       = DK_POOL_MAX;
+    pool->generation = dk_atomic_add_u32(&g_pool_generation, 1) + 1;
+    pool->carved     = 0;
+
+    for (uint32_t i = 0; i < DK_POOL_MAX; i++)
+    {
+        void* expected = NULL;
+        if (dk_atomic_cas_ptr(&g_pool_slots[i], &expected, pool))
+        {
+            pool->slot = i;
+            break;
+        }
+    }
+    DK_CHECK(pool->slot != DK_POOL_MAX, DK_ERRNO_UNKNOWN);
+
+    return DK_STATUS_OK;
+}
+
+void dk_pool_shutdown(dk_pool_t* pool)
+{
+    if (pool->slot == DK_POOL_MAX)
+    {
+        return;
+    }
+
+    memset(&t_pool_caches[pool->slot], 0, sizeof(t_pool_caches[pool->slot]));
+    dk_atomic_store_ptr(&g_pool_slots[pool->slot], NULL);
+
+    pool->head  = DK_POOL_NONE;
+    pool->arena = NULL;
+    pool->slot  = DK_POOL_MAX;
+}
+
+void* dk_pool_alloc(dk_pool_t* pool)
+{
+    dk_pool_cache_t* cache = _dk_pool_cache(pool);
+    if (cache->count == 0 && !_dk_pool_refill(pool, cache))
+    {
+        return NULL;
+    }
+
+    uint32_t* block = _dk_pool_block(pool, cache->head);
+    cache->head     = block[0];
+    cache->count--;
+
+    return block;
+}
+
+void dk_pool_free(dk_pool_t* pool, void* block)
+{
+    if (!block)
+    {
+        return;
+    }
+
+    dk_pool_cache_t* cache = _dk_pool_cache(pool);
+    uint32_t* link         = block;
+
+    link[0]     = cache->head;
+    cache->head = (uint32_t)((uint64_t)((uint8_t*)block - pool->arena->base) / DK_POOL_UNIT);
+    cache->count++;
+
+    if (cache->count == 2 * DK_POOL_CHAIN)
+    {
+        _dk_pool_flush(pool, cache);
+    }
+}
@@ -0,0 +1,53 @@
+#ifndef DEAKO_POOL_H
+#define DEAKO_POOL_H
+
+#include "deako_arena.h"
+
+#include <stdint.h>
+
+#define DK_POOL_MAX 32    // live pools, each one takes a slot in every thread's cache table
+#define DK_POOL_CHAIN 32  // blocks moved between a thread cache and the shared list at once
+#define DK_POOL_UNIT 8    // blocks are addressed in units of this many bytes from the arena base
+#define DK_POOL_NONE UINT32_MAX
+
+/* Fixed-size block allocator carved out of an arena, usually a module's, for small records
+ * created and destroyed at a high rate. Each thread keeps up to 2 * DK_POOL_CHAIN free
+ * blocks per pool and trades whole chains of DK_POOL_CHAIN with a shared lock-free stack,
+ * so alloc and free are a few plain loads and stores, with one CAS per chain.
+ *
+ * The stack head packs a block index with a tag bumped on every change, which keeps a pop
+ * that raced with a pop, free and push of the same block from succeeding (ABA). Blocks are
+ * never returned to the arena; its memory goes when the arena is shut down, after the pool.
+ * The arena must only be allocated from with dk_arena_alloc_atomic while the pool is live.
+ *
+ *     DK_POOL_INIT_TYPE(&pool, &module->arena, dk_request_t);
+ *     dk_request_t* request = DK_POOL_NEW(&pool, dk_request_t);
+ *     dk_pool_free(&pool, request);
+ */
+typedef struct dk_pool {
+    volatile uint64_t head; // (tag << 32) | first chain, DK_POOL_NONE when empty
+    dk_arena_t* arena;
+    uint32_t block_size; // multiple of DK_POOL_UNIT and of align
+    uint32_t align;
+    uint32_t slot;             // index into the thread cache tables
+    uint32_t generation;       // tells a reused slot's stale thread caches apart
+    volatile uint64_t carved;  // blocks taken from the arena
+} dk_pool_t;
+
+#define DK_POOL_INIT_TYPE(pool, arena, type) dk_pool_init((pool), (arena), sizeof(type), DK_ARENA_ALIGN)
+#define DK_POOL_NEW(pool, type) ((type*)dk_pool_alloc(pool))
+
+/* align must be a power of two; block_size is rounded up to it and to DK_POOL_UNIT */
+extern int dk_pool_init(dk_pool_t* pool, dk_arena_t* arena, uint32_t block_size, uint32_t align);
+
+/* Every thread must be done with the pool. Blocks still cached by other threads are dropped
+ * along with it, their memory stays in the arena. */
+extern void dk_pool_shutdown(dk_pool_t* pool);
+
+/* uninitialized memory, NULL once the arena is full */
+extern void* dk_pool_alloc(dk_pool_t* pool);
+
+/* from any thread, not only the one that allocated the block */
+extern void dk_pool_free(dk_pool_t* pool, void* block);
+
+#endif // DEAKO_POOL_H
@@ -0,0 +1,129 @@
+#include "deako_pch.h"
+#include "deako_scratch.h"
+
+#include "platform/deako_atomic.h"
+
+#include <malloc.h>
+#include <string.h>
+
+#define DK_SCRATCH_RESERVE (64ull * 1024 * 1024) // address space per arena, committed as used
+
+typedef struct dk_scratch_thread {
+    dk_arena_t arenas[DK_SCRATCH_COUNT];
+    struct dk_scratch_thread* next;
+} dk_scratch_thread_t;
+
+/* every thread that ever asked for scratch, pushed once and freed at shutdown */
+static void* volatile g_scratch_threads       = NULL; // dk_scratch_thread_t list
+static volatile uint32_t g_scratch_generation = 1;    // bumped by every shutdown
+
+/* same as the profiler's buffers: a thread's arenas are only trusted while the generation
+ * they were made in is current */
+static DK_THREAD_LOCAL dk_scratch_thread_t* t_scratch = NULL;
+static DK_THREAD_LOCAL uint32_t t_scratch_generation  = 0;
+
+/* Untracked on purpose: the shared dk_arena_stats_t counters are atomics every thread would
+ * hit on each allocation, which is the contention scratch arenas exist to avoid. */
+static dk_scratch_thread_t* _dk_scratch_thread(void)
+{
+    uint32_t generation = dk_atomic_load_u32(&g_scratch_generation);
+    if (t_scratch && t_scratch_generation == generation)
+    {
+        return t_scratch;
+    }
+    t_scratch = NULL;
+
+    dk_scratch_thread_t* thread = calloc(1, sizeof(*thread));
+    if (!thread)
+    {
+        return NULL;
+    }
+
+    for (uint32_t i = 0; i < DK_SCRATCH_COUNT; i++)
+    {
+        if (dk_arena_init_virtual(&thread->arenas[i], DK_SCRATCH_RESERVE, DK_ARENA_FLAG_NONE) != DK_STATUS_OK)
+        {
+            for (uint32_t j = 0; j < i; j++)
+            {
+                dk_arena_shutdown(&thread->arenas[j]);
+            }
+            free(thread);
+            return NULL;
+        }
+    }
+
+    void* head = dk_atomic_load_ptr(&g_scratch_threads);
+    do
+    {
+        thread->next = head;
+    } while (!dk_atomic_cas_ptr(&g_scratch_threads, &head, thread));
+
+    t_scratch            = thread;
+    t_scratch_generation = generation;
+    return thread;
+}
+
+dk_scratch_t dk_scratch_begin(const dk_arena_t* conflict)
+{
+    dk_scratch_t scratch        = { 0 };
+    dk_scratch_thread_t* thread = _dk_scratch_thread();
+    if (!thread)
+    {
+        DK_ERROR("scratch: cannot reserve this thread's arenas");
+        return scratch;
+    }
+
+    for (uint32_t i = 0; i < DK_SCRATCH_COUNT; i++)
+    {
+        if (&thread->arenas[i] != conflict)
+        {
+            scratch.arena  = &thread->arenas[i];
+            scratch.offset = scratch.arena->offset;
+            break;
+        }
+    }
+
+    return scratch;
+}
+
+void dk_scratch_end(dk_scratch_t* scratch)
+{
+    dk_arena_t* arena = scratch->arena;
+    if (!arena)
+    {
+        return;
+    }
+
+#if DK_SCRATCH_POISON
+    if (arena->offset > scratch->offset)
+    {
+        memset(arena->base + scratch->offset, DK_SCRATCH_POISON_BYTE, arena->offset - scratch->offset);
+    }
+#endif
+
+    dk_arena_rewind(arena, scratch->offset);
+    scratch->arena = NULL;
+}
+
+void* dk_scratch_alloc(dk_scratch_t* scratch, uint64_t size, uint64_t align)
+{
+    return scratch->arena ? dk_arena_alloc(scratch->arena, size, align) : NULL;
+}
+
+void _dk_scratch_shutdown(void)
+{
+    dk_atomic_add_u32(&g_scratch_generation, 1);
+    dk_scratch_thread_t* thread = dk_atomic_exchange_ptr(&g_scratch_threads, NULL);
+    while (thread)
+    {
+        dk_scratch_thread_t* next = thread->next;
+        for (uint32_t i = 0; i < DK_SCRATCH_COUNT; i++)
+        {
+            dk_arena_shutdown(&thread->arenas[i]);
+        }
+        free(thread);
+        thread = next;
+    }
+
+    t_scratch = NULL;
+}
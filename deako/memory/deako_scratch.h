@@ -0,0 +1,54 @@
+#ifndef DEAKO_SCRATCH_H
+#define DEAKO_SCRATCH_H
+
+#include "deako_arena.h"
+
+#include <stdint.h>
+
+/* Per-thread scratch memory for temporaries that die with the function that made them.
+ * Each thread owns DK_SCRATCH_COUNT virtual arenas, created on first use, and a scope is
+ * just a saved offset: no lock, no atomic, no malloc after the first call on a thread.
+ *
+ *     DK_SCRATCH_SCOPE(scratch, NULL)
+ *     {
+ *         float* samples = dk_scratch_alloc(&scratch, count * sizeof(float), DK_ARENA_ALIGN);
+ *         ...
+ *     }
+ *
+ * Scopes nest. A function that returns memory from an arena it was handed passes that arena
+ * as conflict, so its own temporaries come from the other scratch arena and releasing them
+ * cannot free the result. Leaving a DK_SCRATCH_SCOPE block with return/break/goto skips its
+ * release; use dk_scratch_begin/end around code with early exits. The block always runs once:
+ * if the thread's arenas cannot be made, every dk_scratch_alloc in it returns NULL.
+ *
+ * With DK_SCRATCH_POISON (on in debug builds) released bytes are overwritten with
+ * DK_SCRATCH_POISON_BYTE so reads after the scope ends show up as garbage. */
+
+#define DK_SCRATCH_COUNT 2
+#define DK_SCRATCH_POISON_BYTE 0xdd
+
+#if !defined(DK_SCRATCH_POISON) && defined(DEBUG)
+#define DK_SCRATCH_POISON 1
+#endif
+
+typedef struct dk_scratch {
+    dk_arena_t* arena; // NULL once ended
+    uint64_t offset;   // restored by dk_scratch_end
+} dk_scratch_t;
+
+#define DK_SCRATCH_SCOPE(name, conflict)                                                      \
+    for (dk_scratch_t name = dk_scratch_begin(conflict), *name##_scope = &name; name##_scope; \
+    dk_scratch_end(&name), name##_scope = NULL)
+
+/* conflict may be NULL; the returned arena is NULL if the thread's arenas cannot be made */
+extern dk_scratch_t dk_scratch_begin(const dk_arena_t* conflict);
+extern void dk_scratch_end(dk_scratch_t* scratch);
+
+/* align must be a power of two, NULL when the reservation is used up */
+extern void* dk_scratch_alloc(dk_scratch_t* scratch, uint64_t size, uint64_t align);
+
+/* Releases every thread's scratch arenas. Other threads must be out of their scopes, their
+ * next dk_scratch_begin makes new ones. */
+extern void _dk_scratch_shutdown(void);
+
+#endif // DEAKO_SCRATCH_H
@@ -0,0 +1,440 @@
+#include "deako_pch.h"
+#include "deako_tlsf.h"
+
+#include "platform/deako_bits.h"
+
+#include <string.h>
+
+#define DK_TLSF_FREE 1ull // low bit of dk_tlsf_block_t.size, sizes are DK_ARENA_ALIGN multiples
+#define DK_TLSF_SIZE_MASK (~(uint64_t)(DK_ARENA_ALIGN - 1))
+#define DK_TLSF_HEADER 16      // prev_phys + size
+#define DK_TLSF_MIN_PAYLOAD 16 // room for the free list links
+#define DK_TLSF_SMALL (1ull << DK_TLSF_FL_SHIFT)
+#define DK_TLSF_BLOCK_MAX ((1ull << DK_TLSF_FL_MAX) - 1)
+#define DK_TLSF_REGION_SIZE (1024ull * 1024) // smallest region taken from the arena
+
+/* Every region ends in a zero sized used block so merging never runs off its end. */
+struct dk_tlsf_block {
+    dk_tlsf_block_t* prev_phys; // NULL for the first block of a region
+    uint64_t size;              // payload bytes | DK_TLSF_FREE
+    dk_tlsf_block_t* next_free; // free blocks only, overlaps the payload
+    dk_tlsf_block_t* prev_free;
+};
+
+static uint64_t _dk_tlsf_size(const dk_tlsf_block_t* block)
+{
+    return block->size & DK_TLSF_SIZE_MASK;
+}
+
+static bool _dk_tlsf_is_free(const dk_tlsf_block_t* block)
+{
+    return (block->size & DK_TLSF_FREE) != 0;
+}
+
+static uint8_t* _dk_tlsf_payload(const dk_tlsf_block_t* block)
+{
+    return (uint8_t*)block + DK_TLSF_HEADER;
+}
+
+static dk_tlsf_block_t* _dk_tlsf_block(const void* ptr)
+{
+    return (dk_tlsf_block_t*)((uint8_t*)ptr - DK_TLSF_HEADER);
+}
+
+static dk_tlsf_block_t* _dk_tlsf_next(const dk_tlsf_block_t* block)
+{
+    return (dk_tlsf_block_t*)(_dk_tlsf_payload(block) + _dk_tlsf_size(block));
+}
+
+static uint32_t _dk_tlsf_msb(uint64_t value)
+{
+    return 63 - dk_clz64(value);
+}
+
+static void _dk_tlsf_mapping(uint64_t size, uint32_t* fl, uint32_t* sl)
+{
+    if (size < DK_TLSF_SMALL)
+    {
+        *fl = 0;
+        *sl = (uint32_t)(size / (DK_TLSF_SMALL / DK_TLSF_SL_COUNT));
+        return;
+    }
+
+    uint32_t msb = _dk_tlsf_msb(size);
+    *sl          = (uint32_t)(size >> (msb - DK_TLSF_SL_LOG2)) ^ DK_TLSF_SL_COUNT;
+    *fl          = msb - (DK_TLSF_FL_SHIFT - 1);
+}
+
+/* first size of the next class up, so any block found for it is big enough */
+static uint64_t _dk_tlsf_round(uint64_t size)
+{
+    if (size < DK_TLSF_SMALL)
+    {
+        return size;
+    }
+
+    uint64_t step = 1ull << (_dk_tlsf_msb(size) - DK_TLSF_SL_LOG2);
+    return (size + step - 1) & ~(step - 1);
+}
+
+static void _dk_tlsf_insert(dk_tlsf_t* tlsf, dk_tlsf_block_t* block)
+{
+    uint32_t fl, sl;
+    _dk_tlsf_mapping(_dk_tlsf_size(block), &fl, &sl);
+
+    dk_tlsf_block_t* head = tlsf->free[fl][sl];
+    block->next_free      = head;
+    block->prev_free      = NULL;
+    if (head)
+    {
+        head->prev_free = block;
+    }
+
+    tlsf->free[fl][sl] = block;
+    tlsf->fl_bitmap |= 1u << fl;
+    tlsf->sl_bitmap[fl] |= 1u << sl;
+}
+
+static void _dk_tlsf_remove(dk_tlsf_t* tlsf, dk_tlsf_block_t* block)
+{
+    uint32_t fl, sl;
+    _dk_tlsf_mapping(_dk_tlsf_size(block), &fl, &sl);
+
+    if (block->prev_free)
+    {
+        block->prev_free->next_free = block->next_free;
+    }
+    else
+    {
+        tlsf->free[fl][sl] = block->next_free;
+    }
+
+    if (block->next_free)
+    {
+        block->next_free->prev_free = block->prev_free;
+    }
+
+    if (!tlsf->free[fl][sl])
+    {
+        tlsf->sl_bitmap[fl] &= ~(1u << sl);
+        if (!tlsf->sl_bitmap[fl])
+        {
+            tlsf->fl_bitmap &= ~(1u << fl);
+        }
+    }
+}
+
+/* a free block of at least size bytes, still linked, or NULL */
+static dk_tlsf_block_t* _dk_tlsf_find(const dk_tlsf_t* tlsf, uint64_t size)
+{
+    uint32_t fl, sl;
+    _dk_tlsf_mapping(_dk_tlsf_round(size), &fl, &sl);
+    if (fl >= DK_TLSF_FL_COUNT)
+    {
+        return NULL;
+    }
+
+    uint32_t sl_map = tlsf->sl_bitmap[fl] & (~0u << sl);
+    if (!sl_map)
+    {
+        uint32_t fl_map = (fl + 1 < 32) ? tlsf->fl_bitmap & (~0u << (fl + 1)) : 0;
+        if (!fl_map)
+        {
+            return NULL;
+        }
+
+        fl     = dk_ctz64(fl_map);
+        sl_map = tlsf->sl_bitmap[fl];
+    }
+
+    return tlsf->free[fl][dk_ctz64(sl_map)];
+}
+
+/* marks block free, merges it with free neighbours and links the result */
+static void _dk_tlsf_release(dk_tlsf_t* tlsf, dk_tlsf_block_t* block)
+{
+    dk_tlsf_block_t* prev = block->prev_phys;
+    if (prev && _dk_tlsf_is_free(prev))
+    {
+        _dk_tlsf_remove(tlsf, prev);
+        prev->size = _dk_tlsf_size(prev) + DK_TLSF_HEADER + _dk_tlsf_size(block);
+        block      = prev;
+    }
+
+    dk_tlsf_block_t* next = _dk_tlsf_next(block);
+    if (_dk_tlsf_is_free(next))
+    {
+        _dk_tlsf_remove(tlsf, next);
+        block->size = _dk_tlsf_size(block) + DK_TLSF_HEADER + _dk_tlsf_size(next);
+    }
+
+    block->size |= DK_TLSF_FREE;
+    _dk_tlsf_next(block)->prev_phys = block;
+    _dk_tlsf_insert(tlsf, block);
+}
+
+/* trims a used block to size, giving the tail back when it is big enough to be a block */
+static void _dk_tlsf_split(dk_tlsf_t* tlsf, dk_tlsf_block_t* block, uint64_t size)
+{
+    uint64_t total = _dk_tlsf_size(block);
+    if (total < size + DK_TLSF_HEADER + DK_TLSF_MIN_PAYLOAD)
+    {
+        return;
+    }
+
+    dk_tlsf_block_t* rest          = (dk_tlsf_block_t*)(_dk_tlsf_payload(block) + size);
+    rest->size                     = total - size - DK_TLSF_HEADER;
+    rest->prev_phys                = block;
+    _dk_tlsf_next(rest)->prev_phys = rest;
+    block->size                    = size;
+
+    _dk_tlsf_release(tlsf, rest);
+}
+
+/* takes a region from the arena big enough for size, extending the last one in place when
+ * the arena hands back the memory right after it */
+static bool _dk_tlsf_grow(dk_tlsf_t* tlsf, uint64_t size)
+{
+    uint64_t region = _dk_tlsf_round(size) + 2 * DK_TLSF_HEADER;
+    region          = (region > DK_TLSF_REGION_SIZE) ? region : DK_TLSF_REGION_SIZE;
+    region          = (region + DK_ARENA_ALIGN - 1) & DK_TLSF_SIZE_MASK;
+
+    uint8_t* memory = dk_arena_alloc(tlsf->arena, region, DK_ARENA_ALIGN);
+    if (!memory)
+    {
+        return false;
+    }
+
+    dk_tlsf_block_t* block;
+    if (memory == tlsf->end)
+    {
+        block       = _dk_tlsf_block(memory); // the old end marker
+        block->size = region - DK_TLSF_HEADER;
+    }
+    else
+    {
+        block            = (dk_tlsf_block_t*)memory;
+        block->prev_phys = NULL;
+        block->size      = region - 2 * DK_TLSF_HEADER;
+        tlsf->regions++;
+    }
+
+    dk_tlsf_block_t* end = _dk_tlsf_next(block);
+    end->size            = 0;
+    end->prev_phys       = block;
+    tlsf->end            = memory + region;
+
+    _dk_tlsf_release(tlsf, block);
+    return true;
+}
+
+static uint64_t _dk_tlsf_adjust(uint64_t size)
+{
+    size = (size + DK_ARENA_ALIGN - 1) & DK_TLSF_SIZE_MASK;
+    return (size > DK_TLSF_MIN_PAYLOAD) ? size : DK_TLSF_MIN_PAYLOAD;
+}
+
+/* unlinks and returns a free block of at least size bytes, growing the heap if needed */
+static dk_tlsf_block_t* _dk_tlsf_take(dk_tlsf_t* tlsf, uint64_t size)
+{
+    dk_tlsf_block_t* block = _dk_tlsf_find(tlsf, size);
+    if (!block && _dk_tlsf_grow(tlsf, size))
+    {
+        block = _dk_tlsf_find(tlsf, size);
+    }
+    if (!block)
+    {
+        return NULL;
+    }
+
+    _dk_tlsf_remove(tlsf, block);
+    block->size &= ~DK_TLSF_FREE;
+    return block;
+}
+
+static void _dk_tlsf_used(dk_tlsf_t* tlsf, int64_t bytes, int64_t allocs)
+{
+    tlsf->used += (uint64_t)bytes;
+    tlsf->allocs += (uint64_t)allocs;
+    tlsf->peak = (tlsf->used > tlsf->peak) ? tlsf->used : tlsf->peak;
+}
+
+int dk_tlsf_init(dk_tlsf_t* tlsf, dk_arena_t* arena)
+{
+    DK_CHECK(tlsf && arena, DK_ERRNO_UNKNOWN);
+
+    memset(tlsf, 0, sizeof(*tlsf));
+    tlsf->arena = arena;
+
+    return DK_STATUS_OK;
+}
+
+void dk_tlsf_shutdown(dk_tlsf_t* tlsf)
+{
+    memset(tlsf, 0, sizeof(*tlsf));
+}
+
+void* dk_tlsf_alloc(dk_tlsf_t* tlsf, uint64_t size)
+{
+    if (size > DK_TLSF_BLOCK_MAX)
+    {
+        return NULL;
+    }
+
+    size                   = _dk_tlsf_adjust(size);
+    dk_tlsf_block_t* block = _dk_tlsf_take(tlsf, size);
+    if (!block)
+    {
+        return NULL;
+    }
+
+    _dk_tlsf_split(tlsf, block, size);
+    _dk_tlsf_used(tlsf, (int64_t)_dk_tlsf_size(block), 1);
+
+    return _dk_tlsf_payload(block);
+}
+
+void* dk_tlsf_alloc_aligned(dk_tlsf_t* tlsf, uint64_t size, uint64_t align)
+{
+    if (align <= DK_ARENA_ALIGN)
+    {
+        return dk_tlsf_alloc(tlsf, size);
+    }
+    if (size > DK_TLSF_BLOCK_MAX || (align & (align - 1)) != 0 || align > DK_TLSF_BLOCK_MAX)
+    {
+        return NULL;
+    }
+
+    /* room for a leading gap that is itself a valid block, so it can go back on a list */
+    size                   = _dk_tlsf_adjust(size);
+    uint64_t gap_min       = DK_TLSF_HEADER + DK_TLSF_MIN_PAYLOAD;
+    dk_tlsf_block_t* block = _dk_tlsf_take(tlsf, size + align + gap_min);
+    if (!block)
+    {
+        return NULL;
+    }
+
+    uint64_t payload = (uint64_t)(uintptr_t)_dk_tlsf_payload(block);
+    uint64_t aligned = payload;
+    if (aligned & (align - 1))
+    {
+        aligned = (payload + gap_min + align - 1) & ~(align - 1);
+    }
+
+    if (aligned != payload)
+    {
+        uint64_t gap                    = aligned - payload;
+        dk_tlsf_block_t* moved          = _dk_tlsf_block((void*)(uintptr_t)aligned);
+        moved->size                     = _dk_tlsf_size(block) - gap;
+        moved->prev_phys                = block;
+        _dk_tlsf_next(moved)->prev_phys = moved;
+        block->size                     = gap - DK_TLSF_HEADER;
+
+        _dk_tlsf_release(tlsf, block);
+        block = moved;
+    }
+
+    _dk_tlsf_split(tlsf, block, size);
+    _dk_tlsf_used(tlsf, (int64_t)_dk_tlsf_size(block), 1);
+
+    return _dk_tlsf_payload(block);
+}
+
+void* dk_tlsf_realloc(dk_tlsf_t* tlsf, void* ptr, uint64_t size)
+{
+    if (!ptr)
+    {
+        return dk_tlsf_alloc(tlsf, size);
+    }
+    if (size > DK_TLSF_BLOCK_MAX)
+    {
+        return NULL;
+    }
+
+    dk_tlsf_block_t* block = _dk_tlsf_block(ptr);
+    uint64_t current       = _dk_tlsf_size(block);
+    dk_tlsf_block_t* next  = _dk_tlsf_next(block);
+
+    size = _dk_tlsf_adjust(size);
+    if (size > current)
+    {
+        if (!_dk_tlsf_is_free(next) || current + DK_TLSF_HEADER + _dk_tlsf_size(next) < size)
+        {
+            void* moved = dk_tlsf_alloc(tlsf, size);
+            if (moved)
+            {
+                memcpy(moved, ptr, current);
+                dk_tlsf_free(tlsf, ptr);
+            }
+            return moved;
+        }
+
+        _dk_tlsf_remove(tlsf, next);
+        block->size                     = current + DK_TLSF_HEADER + _dk_tlsf_size(next);
+        _dk_tlsf_next(block)->prev_phys = block;
+    }
+
+    _dk_tlsf_split(tlsf, block, size);
+    _dk_tlsf_used(tlsf, (int64_t)_dk_tlsf_size(block) - (int64_t)current, 0);
+
+    return ptr;
+}
+
+void dk_tlsf_free(dk_tlsf_t* tlsf, void* ptr)
+{
+    if (!ptr)
+    {
+        return;
+    }
+
+    dk_tlsf_block_t* block = _dk_tlsf_block(ptr);
+    _dk_tlsf_used(tlsf, -(int64_t)_dk_tlsf_size(block), -1);
+    _dk_tlsf_release(tlsf, block);
+}
+
+uint64_t dk_tlsf_size(const void* ptr)
+{
+    return ptr ? _dk_tlsf_size(_dk_tlsf_block(ptr)) : 0;
+}
+
+void dk_tlsf_stats(const dk_tlsf_t* tlsf, dk_tlsf_stats_t* stats)
+{
+    memset(stats, 0, sizeof(*stats));
+    stats->used    = tlsf->used;
+    stats->peak    = tlsf->peak;
+    stats->allocs  = tlsf->allocs;
+    stats->regions = tlsf->regions;
+
+    for (uint32_t fl = 0; fl < DK_TLSF_FL_COUNT; fl++)
+    {
+        for (uint32_t sl = 0; sl < DK_TLSF_SL_COUNT; sl++)
+        {
+            for (const dk_tlsf_block_t* block = tlsf->free[fl][sl]; block; block = block->next_free)
+            {
+                uint64_t size       = _dk_tlsf_size(block);
+                stats->free        += size;
+                stats->largest_free = (size > stats->largest_free) ? size : stats->largest_free;
+                stats->free_blocks++;
+            }
+        }
+    }
+
+    stats->fragmentation = stats->free ? 1.0 - (double)stats->largest_free / (double)stats->free : 0.0;
+}
+
+void dk_tlsf_report(const dk_tlsf_t* tlsf, const char* name)
+{
+    dk_tlsf_stats_t stats;
+    dk_tlsf_stats(tlsf, &stats);
+
+    DK_INFO("heap %s: %.1f KiB used (peak %.1f KiB), %.1f KiB free in %u blocks, largest %.1f KiB, "
+            "%.1f%% fragmented, %u regions",
+    name, (double)stats.used / 1024, (double)stats.peak / 1024, (double)stats.free / 1024, stats.free_blocks,
+    (double)stats.largest_free / 1024, stats.fragmentation * 100, stats.regions);
+
+    if (stats.allocs)
+    {
+        DK_WARN("heap %s: %llu allocations (%.1f KiB) never freed", name, (unsigned long long)stats.allocs,
+        (double)stats.used / 1024);
+    }
+}
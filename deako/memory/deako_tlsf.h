@@ -0,0 +1,68 @@
+#ifndef DEAKO_TLSF_H
+#define DEAKO_TLSF_H
+
+#include "deako_arena.h"
+
+#include <stdint.h>
+
+#define DK_TLSF_SL_LOG2 5 // second level subdivisions per power of two, 32
+#define DK_TLSF_SL_COUNT (1 << DK_TLSF_SL_LOG2)
+#define DK_TLSF_FL_SHIFT 9 // log2 of the smallest size with a first level of its own, 512
+#define DK_TLSF_FL_MAX 32  // blocks stay below 4 GiB
+#define DK_TLSF_FL_COUNT (DK_TLSF_FL_MAX - DK_TLSF_FL_SHIFT + 1)
+
+typedef struct dk_tlsf_block dk_tlsf_block_t;
+
+/* Two-level segregated fit heap (Masmano et al.) over memory carved from an arena, for
+ * modules whose allocations are freed and resized one by one. Free blocks sit in a list
+ * per size class, a power of two split in DK_TLSF_SL_COUNT steps, with a bitmap per level,
+ * so alloc, free and the merge of physical neighbours are O(1) bit scans and list
+ * splices. Requests are rounded up to the next class, a waste bounded by 1/32 of the size.
+ *
+ * Blocks carry a 16 byte header and payloads are DK_ARENA_ALIGN aligned. When the free
+ * lists cannot serve a request the heap takes another region from the arena; consecutive
+ * regions of a virtual arena are contiguous and merge into one. Not thread safe. */
+typedef struct dk_tlsf {
+    dk_arena_t* arena;
+    uint8_t* end; // one past the last region, where a contiguous one would start
+    uint32_t fl_bitmap;
+    uint32_t sl_bitmap[DK_TLSF_FL_COUNT];
+    dk_tlsf_block_t* free[DK_TLSF_FL_COUNT][DK_TLSF_SL_COUNT];
+    uint64_t used; // payload bytes of allocated blocks
+    uint64_t peak;
+    uint64_t allocs; // live
+    uint32_t regions;
+} dk_tlsf_t;
+
+typedef struct dk_tlsf_stats {
+    uint64_t used;
+    uint64_t peak;
+    uint64_t free;         // payload bytes of free blocks
+    uint64_t largest_free; // biggest single allocation that fits without growing
+    uint64_t allocs;
+    uint32_t free_blocks;
+    uint32_t regions;
+    double fragmentation; // 1 - largest_free / free, 0 when the free space is one block
+} dk_tlsf_stats_t;
+
+extern int dk_tlsf_init(dk_tlsf_t* tlsf, dk_arena_t* arena);
+
+/* the heap's memory belongs to the arena and goes with it */
+extern void dk_tlsf_shutdown(dk_tlsf_t* tlsf);
+
+/* NULL when the arena is full, size 0 gives the smallest block */
+extern void* dk_tlsf_alloc(dk_tlsf_t* tlsf, uint64_t size);
+extern void* dk_tlsf_alloc_aligned(dk_tlsf_t* tlsf, uint64_t size, uint64_t align);
+
+/* grows in place into a free neighbour when it can; NULL leaves ptr untouched */
+extern void* dk_tlsf_realloc(dk_tlsf_t* tlsf, void* ptr, uint64_t size);
+extern void dk_tlsf_free(dk_tlsf_t* tlsf, void* ptr);
+
+/* usable bytes of an allocation, at least what was asked for */
+extern uint64_t dk_tlsf_size(const void* ptr);
+
+/* walks every block, O(blocks) */
+extern void dk_tlsf_stats(const dk_tlsf_t* tlsf, dk_tlsf_stats_t* stats);
+extern void dk_tlsf_report(const dk_tlsf_t* tlsf, const char* name);
+
+#endif // DEAKO_TLSF_H
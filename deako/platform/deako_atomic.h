@@ -0,0 +1,197 @@
+#ifndef DEAKO_ATOMIC_H
+#define DEAKO_ATOMIC_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* C99 has no <stdatomic.h>, so the handful of operations deako needs are mapped onto the
+ * compiler intrinsics. Loads acquire, stores release, read-modify-writes are sequentially
+ * consistent. */
+
+#ifdef _MSC_VER
+#include <intrin.h>
+
+#define DK_THREAD_LOCAL __declspec(thread)
+#define DK_CACHE_LINE 64
+#define DK_ALIGNED(n) __declspec(align(n))
+
+static inline uint32_t dk_atomic_load_u32(const volatile uint32_t* ptr)
+{
+    uint32_t value = *ptr;
+    _ReadWriteBarrier();
+    return value;
+}
+
+static inline void dk_atomic_store_u32(volatile uint32_t* ptr, uint32_t value)
+{
+    _ReadWriteBarrier();
+    *ptr = value;
+}
+
+static inline uint32_t dk_atomic_add_u32(volatile uint32_t* ptr, uint32_t value)
+{
+    return (uint32_t)_InterlockedExchangeAdd((volatile long*)ptr, (long)value);
+}
+
+static inline bool dk_atomic_cas_u32(volatile uint32_t* ptr, uint32_t* expected, uint32_t desired)
+{
+    uint32_t previous = (uint32_t)_InterlockedCompareExchange((volatile long*)ptr, (long)desired, (long)*expected);
+    bool success      = (previous == *expected);
+    *expected         = previous;
+    return success;
+}
+
+static inline uint64_t dk_atomic_load_u64(const volatile uint64_t* ptr)
+{
+    uint64_t value = *ptr;
+    _ReadWriteBarrier();
+    return value;
+}
+
+static inline void dk_atomic_store_u64(volatile uint64_t* ptr, uint64_t value)
+{
+    _ReadWriteBarrier();
+    *ptr = value;
+}
+
+static inline uint64_t dk_atomic_add_u64(volatile uint64_t* ptr, uint64_t value)
+{
+    return (uint64_t)_InterlockedExchangeAdd64((volatile __int64*)ptr, (__int64)value);
+}
+
+static inline uint64_t dk_atomic_exchange_u64(volatile uint64_t* ptr, uint64_t value)
+{
+    return (uint64_t)_InterlockedExchange64((volatile __int64*)ptr, (__int64)value);
+}
+
+static inline bool dk_atomic_cas_u64(volatile uint64_t* ptr, uint64_t* expected, uint64_t desired)
+{
+    uint64_t previous =
+    (uint64_t)_InterlockedCompareExchange64((volatile __int64*)ptr, (__int64)desired, (__int64)*expected);
+    bool success = (previous == *expected);
+    *expected    = previous;
+    return success;
+}
+
+static inline void* dk_atomic_load_ptr(void* const volatile* ptr)
+{
+    void* value = *ptr;
+    _ReadWriteBarrier();
+    return value;
+}
+
+static inline void dk_atomic_store_ptr(void* volatile* ptr, void* value)
+{
+    _ReadWriteBarrier();
+    *ptr = value;
+}
+
+static inline void* dk_atomic_exchange_ptr(void* volatile* ptr, void* value)
+{
+    return _InterlockedExchangePointer(ptr, value);
+}
+
+static inline bool dk_atomic_cas_ptr(void* volatile* ptr, void** expected, void* desired)
+{
+    void* previous = _InterlockedCompareExchangePointer(ptr, desired, *expected);
+    bool success   = (previous == *expected);
+    *expected      = previous;
+    return success;
+}
+
+static inline void dk_atomic_fence(void)
+{
+    _mm_mfence();
+}
+
+static inline void dk_atomic_pause(void)
+{
+    _mm_pause();
+}
+
+#else
+
+#define DK_THREAD_LOCAL __thread
+#define DK_CACHE_LINE 64
+#define DK_ALIGNED(n) __attribute__((aligned(n)))
+
+static inline uint32_t dk_atomic_load_u32(const volatile uint32_t* ptr)
+{
+    return __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
+}
+
+static inline void dk_atomic_store_u32(volatile uint32_t* ptr, uint32_t value)
+{
+    __atomic_store_n(ptr, value, __ATOMIC_RELEASE);
+}
+
+static inline uint32_t dk_atomic_add_u32(volatile uint32_t* ptr, uint32_t value)
+{
+    return __atomic_fetch_add(ptr, value, __ATOMIC_SEQ_CST);
+}
+
+static inline bool dk_atomic_cas_u32(volatile uint32_t* ptr, uint32_t* expected, uint32_t desired)
+{
+    return __atomic_compare_exchange_n(ptr, expected, desired, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+
+static inline uint64_t dk_atomic_load_u64(const volatile uint64_t* ptr)
+{
+    return __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
+}
+
+static inline void dk_atomic_store_u64(volatile uint64_t* ptr, uint64_t value)
+{
+    __atomic_store_n(ptr, value, __ATOMIC_RELEASE);
+}
+
+static inline uint64_t dk_atomic_add_u64(volatile uint64_t* ptr, uint64_t value)
+{
+    return __atomic_fetch_add(ptr, value, __ATOMIC_SEQ_CST);
+}
+
+static inline uint64_t dk_atomic_exchange_u64(volatile uint64_t* ptr, uint64_t value)
+{
+    return __atomic_exchange_n(ptr, value, __ATOMIC_SEQ_CST);
+}
+
+static inline bool dk_atomic_cas_u64(volatile uint64_t* ptr, uint64_t* expected, uint64_t desired)
+{
+    return __atomic_compare_exchange_n(ptr, expected, desired, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+
+static inline void* dk_atomic_load_ptr(void* const volatile* ptr)
+{
+    return __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
+}
+
+static inline void dk_atomic_store_ptr(void* volatile* ptr, void* value)
+{
+    __atomic_store_n(ptr, value, __ATOMIC_RELEASE);
+}
+
+static inline void* dk_atomic_exchange_ptr(void* volatile* ptr, void* value)
+{
+    return __atomic_exchange_n(ptr, value, __ATOMIC_SEQ_CST);
+}
+
+static inline bool dk_atomic_cas_ptr(void* volatile* ptr, void** expected, void* desired)
+{
+    return __atomic_compare_exchange_n(ptr, expected, desired, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+
+static inline void dk_atomic_fence(void)
+{
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+static inline void dk_atomic_pause(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+}
+
+#endif
+
+#endif // DEAKO_ATOMIC_H
@@ -0,0 +1,43 @@
+#ifndef DEAKO_BITS_H
+#define DEAKO_BITS_H
+
+#include <stdint.h>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+/* value must be non-zero */
+static inline uint32_t dk_ctz64(uint64_t value)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, value);
+    return (uint32_t)index;
+#else
+    return (uint32_t)__builtin_ctzll(value);
+#endif
+}
+
+/* value must be non-zero */
+static inline uint32_t dk_clz64(uint64_t value)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanReverse64(&index, value);
+    return 63 - (uint32_t)index;
+#else
+    return (uint32_t)__builtin_clzll(value);
+#endif
+}
+
+static inline uint32_t dk_popcount64(uint64_t value)
+{
+#ifdef _MSC_VER
+    return (uint32_t)__popcnt64(value);
+#else
+    return (uint32_t)__builtin_popcountll(value);
+#endif
+}
+
+#endif // DEAKO_BITS_H
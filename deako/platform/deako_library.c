@@ -0,0 +1,111 @@
+#include "deako_pch.h"
+#include "deako_library.h"
+
+#include <stdio.h>
+
+#ifdef DK_PLATFORM_WINDOWS
+#include <windows.h>
+#else
+#include <dlfcn.h>
+#include <sys/stat.h>
+#endif
+
+#ifdef DK_PLATFORM_WINDOWS
+
+dk_library_t dk_library_open(const char* path)
+{
+    HMODULE library = LoadLibraryA(path);
+    if (!library)
+    {
+        DK_ERROR("LoadLibrary %s failed (%lu)", path, (unsigned long)GetLastError());
+    }
+    return (dk_library_t)library;
+}
+
+void* dk_library_symbol(dk_library_t library, const char* name)
+{
+    return (void*)GetProcAddress((HMODULE)library, name);
+}
+
+void dk_library_close(dk_library_t library)
+{
+    FreeLibrary((HMODULE)library);
+}
+
+uint64_t dk_file_mtime(const char* path)
+{
+    WIN32_FILE_ATTRIBUTE_DATA data;
+    if (!GetFileAttributesExA(path, GetFileExInfoStandard, &data))
+    {
+        return 0;
+    }
+
+    /* 100 ns ticks since 1601, only ever compared with each other */
+    uint64_t ticks = ((uint64_t)data.ftLastWriteTime.dwHighDateTime << 32) | data.ftLastWriteTime.dwLowDateTime;
+    return ticks * 100;
+}
+
+#else
+
+dk_library_t dk_library_open(const char* path)
+{
+    void* library = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+    if (!library)
+    {
+        DK_ERROR("dlopen %s failed: %s", path, dlerror());
+    }
+    return library;
+}
+
+void* dk_library_symbol(dk_library_t library, const char* name)
+{
+    return dlsym(library, name);
+}
+
+void dk_library_close(dk_library_t library)
+{
+    dlclose(library);
+}
+
+uint64_t dk_file_mtime(const char* path)
+{
+    struct stat info;
+    if (stat(path, &info) != 0)
+    {
+        return 0;
+    }
+
+    return (uint64_t)info.st_mtim.tv_sec * DK_NS_PER_S + (uint64_t)info.st_mtim.tv_nsec;
+}
+
+#endif
+
+bool dk_file_copy(const char* from, const char* to)
+{
+    FILE* input  = fopen(from, "rb");
+    FILE* output = input ? fopen(to, "wb") : NULL;
+    bool ok      = input && output;
+
+    char buffer[64 * 1024];
+    while (ok)
+    {
+        size_t size = fread(buffer, 1, sizeof(buffer), input);
+        if (size == 0)
+        {
+            ok = !ferror(input);
+            break;
+        }
+        ok = fwrite(buffer, 1, size, output) == size;
+    }
+
+    if (input)
+    {
+        fclose(input);
+    }
+    if (output && fclose(output) != 0)
+    {
+        ok = false;
+    }
+
+    return ok;
+}
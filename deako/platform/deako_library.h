@@ -0,0 +1,18 @@
+#ifndef DEAKO_LIBRARY_H
+#define DEAKO_LIBRARY_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef void* dk_library_t;
+
+/* Shared libraries (.so/.dll). NULL on failure, the reason is logged. */
+extern dk_library_t dk_library_open(const char* path);
+extern void* dk_library_symbol(dk_library_t library, const char* name);
+extern void dk_library_close(dk_library_t library);
+
+/* last modification in ns since the epoch, 0 if the file does not exist */
+extern uint64_t dk_file_mtime(const char* path);
+extern bool dk_file_copy(const char* from, const char* to);
+
+#endif // DEAKO_LIBRARY_H
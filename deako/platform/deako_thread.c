@@ -0,0 +1,220 @@
+#include "deako_pch.h"
+#include "deako_thread.h"
+
+#include "deako_atomic.h"
+
+#ifdef DK_PLATFORM_WINDOWS
+#include <windows.h>
+#elif defined(__APPLE__)
+#include <sched.h>
+#include <sys/time.h>
+#include <unistd.h>
+#else
+#include <sched.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+static DK_THREAD_LOCAL uint32_t t_thread_id = 0;
+
+uint32_t dk_thread_id(void)
+{
+    if (t_thread_id == 0)
+    {
+#ifdef DK_PLATFORM_WINDOWS
+        t_thread_id = (uint32_t)GetCurrentThreadId();
+#elif defined(__APPLE__)
+        uint64_t id;
+        pthread_threadid_np(NULL, &id);
+        t_thread_id = (uint32_t)id;
+#else
+        t_thread_id = (uint32_t)syscall(SYS_gettid);
+#endif
+    }
+
+    return t_thread_id;
+}
+
+uint32_t dk_cpu_count(void)
+{
+#ifdef DK_PLATFORM_WINDOWS
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (uint32_t)info.dwNumberOfProcessors;
+#else
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return (count > 0) ? (uint32_t)count : 1;
+#endif
+}
+
+#ifdef DK_PLATFORM_WINDOWS
+
+static DWORD WINAPI _dk_thread_main(LPVOID param)
+{
+    dk_thread_t* thread = (dk_thread_t*)param;
+    thread->fn(thread->data);
+    return 0;
+}
+
+int dk_thread_create(dk_thread_t* thread, dk_thread_fn fn, void* data)
+{
+    thread->fn     = fn;
+    thread->data   = data;
+    thread->handle = CreateThread(NULL, 0, _dk_thread_main, thread, 0, NULL);
+    DK_CHECK(thread->handle, DK_ERRNO_UNKNOWN);
+    return DK_STATUS_OK;
+}
+
+void dk_thread_join(dk_thread_t* thread)
+{
+    WaitForSingleObject((HANDLE)thread->handle, INFINITE);
+    CloseHandle((HANDLE)thread->handle);
+}
+
+void dk_thread_yield(void)
+{
+    SwitchToThread();
+}
+
+void dk_mutex_init(dk_mutex_t* mutex)
+{
+    InitializeSRWLock((PSRWLOCK)&mutex->lock);
+}
+
+void dk_mutex_destroy(dk_mutex_t* mutex)
+{
+    (void)mutex;
+}
+
+void dk_mutex_lock(dk_mutex_t* mutex)
+{
+    AcquireSRWLockExclusive((PSRWLOCK)&mutex->lock);
+}
+
+void dk_mutex_unlock(dk_mutex_t* mutex)
+{
+    ReleaseSRWLockExclusive((PSRWLOCK)&mutex->lock);
+}
+
+void dk_cond_init(dk_cond_t* cond)
+{
+    InitializeConditionVariable((PCONDITION_VARIABLE)&cond->cond);
+}
+
+void dk_cond_destroy(dk_cond_t* cond)
+{
+    (void)cond;
+}
+
+void dk_cond_wait(dk_cond_t* cond, dk_mutex_t* mutex)
+{
+    SleepConditionVariableSRW((PCONDITION_VARIABLE)&cond->cond, (PSRWLOCK)&mutex->lock, INFINITE, 0);
+}
+
+bool dk_cond_wait_timeout(dk_cond_t* cond, dk_mutex_t* mutex, uint64_t timeout)
+{
+    DWORD ms = (DWORD)((timeout + DK_NS_PER_MS - 1) / DK_NS_PER_MS);
+    return SleepConditionVariableSRW((PCONDITION_VARIABLE)&cond->cond, (PSRWLOCK)&mutex->lock, ms, 0) != 0;
+}
+
+void dk_cond_signal(dk_cond_t* cond)
+{
+    WakeConditionVariable((PCONDITION_VARIABLE)&cond->cond);
+}
+
+void dk_cond_broadcast(dk_cond_t* cond)
+{
+    WakeAllConditionVariable((PCONDITION_VARIABLE)&cond->cond);
+}
+
+#else
+
+static void* _dk_thread_main(void* param)
+{
+    dk_thread_t* thread = (dk_thread_t*)param;
+    thread->fn(thread->data);
+    return NULL;
+}
+
+int dk_thread_create(dk_thread_t* thread, dk_thread_fn fn, void* data)
+{
+    thread->fn   = fn;
+    thread->data = data;
+    DK_CHECK(pthread_create(&thread->handle, NULL, _dk_thread_main, thread) == 0, DK_ERRNO_UNKNOWN);
+    return DK_STATUS_OK;
+}
+
+void dk_thread_join(dk_thread_t* thread)
+{
+    pthread_join(thread->handle, NULL);
+}
+
+void dk_thread_yield(void)
+{
+    sched_yield();
+}
+
+void dk_mutex_init(dk_mutex_t* mutex)
+{
+    pthread_mutex_init(&mutex->lock, NULL);
+}
+
+void dk_mutex_destroy(dk_mutex_t* mutex)
+{
+    pthread_mutex_destroy(&mutex->lock);
+}
+
+void dk_mutex_lock(dk_mutex_t* mutex)
+{
+    pthread_mutex_lock(&mutex->lock);
+}
+
+void dk_mutex_unlock(dk_mutex_t* mutex)
+{
+    pthread_mutex_unlock(&mutex->lock);
+}
+
+void dk_cond_init(dk_cond_t* cond)
+{
+    pthread_cond_init(&cond->cond, NULL);
+}
+
+void dk_cond_destroy(dk_cond_t* cond)
+{
+    pthread_cond_destroy(&cond->cond);
+}
+
+void dk_cond_wait(dk_cond_t* cond, dk_mutex_t* mutex)
+{
+    pthread_cond_wait(&cond->cond, &mutex->lock);
+}
+
+bool dk_cond_wait_timeout(dk_cond_t* cond, dk_mutex_t* mutex, uint64_t timeout)
+{
+    struct timespec ts;
+#ifdef __APPLE__
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    ts.tv_sec  = tv.tv_sec;
+    ts.tv_nsec = tv.tv_usec * 1000;
+#else
+    clock_gettime(CLOCK_REALTIME, &ts);
+#endif
+    uint64_t nsec = (uint64_t)ts.tv_nsec + timeout % DK_NS_PER_S;
+    ts.tv_sec += (time_t)(timeout / DK_NS_PER_S + nsec / DK_NS_PER_S);
+    ts.tv_nsec = (long)(nsec % DK_NS_PER_S);
+    return pthread_cond_timedwait(&cond->cond, &mutex->lock, &ts) == 0;
+}
+
+void dk_cond_signal(dk_cond_t* cond)
+{
+    pthread_cond_signal(&cond->cond);
+}
+
+void dk_cond_broadcast(dk_cond_t* cond)
+{
+    pthread_cond_broadcast(&cond->cond);
+}
+
+#endif
@@ -0,0 +1,61 @@
+#ifndef DEAKO_THREAD_H
+#define DEAKO_THREAD_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifndef DK_PLATFORM_WINDOWS
+#include <pthread.h>
+#endif
+
+typedef void (*dk_thread_fn)(void* data);
+
+/* Windows handles are kept as opaque pointers so <windows.h> stays out of this header,
+ * SRWLOCK and CONDITION_VARIABLE are both a single pointer. */
+typedef struct dk_thread {
+#ifdef DK_PLATFORM_WINDOWS
+    void* handle;
+#else
+    pthread_t handle;
+#endif
+    dk_thread_fn fn;
+    void* data;
+} dk_thread_t;
+
+typedef struct dk_mutex {
+#ifdef DK_PLATFORM_WINDOWS
+    void* lock;
+#else
+    pthread_mutex_t lock;
+#endif
+} dk_mutex_t;
+
+typedef struct dk_cond {
+#ifdef DK_PLATFORM_WINDOWS
+    void* cond;
+#else
+    pthread_cond_t cond;
+#endif
+} dk_cond_t;
+
+extern uint32_t dk_thread_id(void);
+extern uint32_t dk_cpu_count(void);
+
+/* thread must stay valid until dk_thread_join returns */
+extern int dk_thread_create(dk_thread_t* thread, dk_thread_fn fn, void* data);
+extern void dk_thread_join(dk_thread_t* thread);
+extern void dk_thread_yield(void);
+
+extern void dk_mutex_init(dk_mutex_t* mutex);
+extern void dk_mutex_destroy(dk_mutex_t* mutex);
+extern void dk_mutex_lock(dk_mutex_t* mutex);
+extern void dk_mutex_unlock(dk_mutex_t* mutex);
+
+extern void dk_cond_init(dk_cond_t* cond);
+extern void dk_cond_destroy(dk_cond_t* cond);
+extern void dk_cond_wait(dk_cond_t* cond, dk_mutex_t* mutex);
+extern bool dk_cond_wait_timeout(dk_cond_t* cond, dk_mutex_t* mutex, uint64_t timeout); // ns, false on timeout
+extern void dk_cond_signal(dk_cond_t* cond);
+extern void dk_cond_broadcast(dk_cond_t* cond);
+
+#endif // DEAKO_THREAD_H
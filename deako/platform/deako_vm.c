@@ -0,0 +1,100 @@
+#include "deako_pch.h"
+#include "deako_vm.h"
+
+#ifdef DK_PLATFORM_WINDOWS
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+uint64_t dk_vm_page_size(void)
+{
+#ifdef DK_PLATFORM_WINDOWS
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (uint64_t)info.dwPageSize;
+#else
+    long size = sysconf(_SC_PAGESIZE);
+    return (size > 0) ? (uint64_t)size : 4096;
+#endif
+}
+
+#ifdef DK_PLATFORM_WINDOWS
+
+/* Large pages have to be committed up front and need SeLockMemoryPrivilege, which does not
+ * fit commit on demand; huge is ignored here. */
+void* dk_vm_reserve(uint64_t size, bool huge)
+{
+    (void)huge;
+    return VirtualAlloc(NULL, (SIZE_T)size, MEM_RESERVE, PAGE_NOACCESS);
+}
+
+void dk_vm_release(void* base, uint64_t size)
+{
+    (void)size;
+    VirtualFree(base, 0, MEM_RELEASE);
+}
+
+bool dk_vm_commit(void* address, uint64_t size)
+{
+    return VirtualAlloc(address, (SIZE_T)size, MEM_COMMIT, PAGE_READWRITE) != NULL;
+}
+
+void dk_vm_decommit(void* address, uint64_t size)
+{
+    VirtualFree(address, (SIZE_T)size, MEM_DECOMMIT);
+}
+
+#else
+
+/* MAP_HUGETLB is not used: lazily touched hugetlb pages SIGBUS once the pool runs dry, while
+ * MADV_HUGEPAGE falls back to small pages. The range is 2 MiB aligned so it can be backed
+ * by whole huge pages. */
+void* dk_vm_reserve(uint64_t size, bool huge)
+{
+    uint64_t extra = huge ? DK_VM_HUGE_PAGE_SIZE : 0;
+    uint8_t* base  = mmap(NULL, size + extra, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (base == MAP_FAILED)
+    {
+        return NULL;
+    }
+
+    if (huge)
+    {
+        uint8_t* aligned = (uint8_t*)(((uintptr_t)base + extra - 1) & ~(uintptr_t)(extra - 1));
+        if (aligned > base)
+        {
+            munmap(base, aligned - base);
+        }
+        if (aligned + size < base + size + extra)
+        {
+            munmap(aligned + size, (base + size + extra) - (aligned + size));
+        }
+        base = aligned;
+
+#ifdef MADV_HUGEPAGE
+        madvise(base, size, MADV_HUGEPAGE);
+#endif
+    }
+
+    return base;
+}
+
+void dk_vm_release(void* base, uint64_t size)
+{
+    munmap(base, size);
+}
+
+bool dk_vm_commit(void* address, uint64_t size)
+{
+    return mprotect(address, size, PROT_READ | PROT_WRITE) == 0;
+}
+
+void dk_vm_decommit(void* address, uint64_t size)
+{
+    madvise(address, size, MADV_DONTNEED);
+    mprotect(address, size, PROT_NONE);
+}
+
+#endif
@@ -0,0 +1,20 @@
+#ifndef DEAKO_VM_H
+#define DEAKO_VM_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define DK_VM_HUGE_PAGE_SIZE (2ull * 1024 * 1024)
+
+extern uint64_t dk_vm_page_size(void);
+
+/* Address space only, nothing is backed until committed. huge asks for transparent huge
+ * pages on the range where the platform supports it. NULL on failure. */
+extern void* dk_vm_reserve(uint64_t size, bool huge);
+extern void dk_vm_release(void* base, uint64_t size);
+
+/* page aligned ranges inside a reservation */
+extern bool dk_vm_commit(void* address, uint64_t size);
+extern void dk_vm_decommit(void* address, uint64_t size);
+
+#endif // DEAKO_VM_H
@@ -18,7 +18,6 @@ project "deako"
       "%{IncludeDir.cglm}",
       "%{IncludeDir.log}",
       "%{IncludeDir.glfw}", 
-      "%{IncludeDir.magic_memory}", 
       "%{IncludeDir.vulkan}", 
    }
 
@@ -31,10 +30,16 @@ project "deako"
    {
        "log",
        "glfw",
-       "magic_memory",
        "vulkan-1",
    }
 
+   filter "system:linux"
+      links
+      {
+         "pthread",
+         "dl",
+      }
+
    filter "system:windows"
       systemversion "latest"
       defines
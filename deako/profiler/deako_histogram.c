@@ -0,0 +1,80 @@
+#include "deako_pch.h"
+#include "deako_histogram.h"
+
+#include "platform/deako_bits.h"
+
+#include <string.h>
+
+static uint32_t _dk_histogram_index(uint64_t value)
+{
+    if (value < DK_HISTOGRAM_SUB_COUNT)
+    {
+        return (uint32_t)value;
+    }
+
+    uint32_t exponent = 63 - dk_clz64(value);
+    uint32_t sub      = (uint32_t)(value >> (exponent - DK_HISTOGRAM_SUB_BITS)) & (DK_HISTOGRAM_SUB_COUNT - 1);
+    return (exponent - DK_HISTOGRAM_SUB_BITS + 1) * DK_HISTOGRAM_SUB_COUNT + sub;
+}
+
+/* midpoint of the bucket, the best guess for any value that landed in it */
+static uint64_t _dk_histogram_value(uint32_t index)
+{
+    if (index < DK_HISTOGRAM_SUB_COUNT)
+    {
+        return index;
+    }
+
+    uint32_t exponent = index / DK_HISTOGRAM_SUB_COUNT + DK_HISTOGRAM_SUB_BITS - 1;
+    uint64_t sub      = index % DK_HISTOGRAM_SUB_COUNT;
+    uint32_t shift    = exponent - DK_HISTOGRAM_SUB_BITS;
+    uint64_t lower    = (DK_HISTOGRAM_SUB_COUNT + sub) << shift;
+    return lower + (((uint64_t)1 << shift) >> 1);
+}
+
+void _dk_histogram_reset(dk_histogram_t* histogram)
+{
+    memset(histogram, 0, sizeof(*histogram));
+    histogram->min = UINT64_MAX;
+}
+
+void _dk_histogram_record(dk_histogram_t* histogram, uint64_t value)
+{
+    const uint64_t limit = ((uint64_t)1 << DK_HISTOGRAM_MAX_BITS) - 1;
+
+    histogram->counts[_dk_histogram_index(value < limit ? value : limit)]++;
+    histogram->count++;
+    histogram->sum += value;
+    histogram->min = (value < histogram->min) ? value : histogram->min;
+    histogram->max = (value > histogram->max) ? value : histogram->max;
+}
+
+/* percentile in [0, 100], the exact max is returned for 100 */
+uint64_t _dk_histogram_percentile(const dk_histogram_t* histogram, double percentile)
+{
+    if (histogram->count == 0)
+    {
+        return 0;
+    }
+
+    if (percentile >= 100.0)
+    {
+        return histogram->max;
+    }
+
+    uint64_t rank  = (uint64_t)(percentile / 100.0 * (double)histogram->count + 0.5);
+    uint64_t total = 0;
+    rank           = rank ? rank : 1;
+
+    for (uint32_t i = 0; i < DK_HISTOGRAM_BUCKETS; i++)
+    {
+        total += histogram->counts[i];
+        if (total >= rank)
+        {
+            uint64_t value = _dk_histogram_value(i);
+            return (value > histogram->max) ? histogram->max : (value < histogram->min) ? histogram->min : value;
+        }
+    }
+
+    return histogram->max;
+}
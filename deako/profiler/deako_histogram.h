@@ -0,0 +1,26 @@
+#ifndef DEAKO_HISTOGRAM_H
+#define DEAKO_HISTOGRAM_H
+
+#include <stdint.h>
+
+/* Log-linear (HDR style) histogram of ns durations: 16 linear sub-buckets per power of
+ * two keeps every reported value within ~6% of the real one from 16 ns up to ~36 min,
+ * at a fixed 2.4 KB and an O(1) record. */
+#define DK_HISTOGRAM_SUB_BITS 4
+#define DK_HISTOGRAM_SUB_COUNT (1u << DK_HISTOGRAM_SUB_BITS)
+#define DK_HISTOGRAM_MAX_BITS 41
+#define DK_HISTOGRAM_BUCKETS ((DK_HISTOGRAM_MAX_BITS - DK_HISTOGRAM_SUB_BITS + 1) * DK_HISTOGRAM_SUB_COUNT)
+
+typedef struct dk_histogram {
+    uint32_t counts[DK_HISTOGRAM_BUCKETS];
+    uint64_t count;
+    uint64_t sum; // ns
+    uint64_t min; // ns
+    uint64_t max; // ns
+} dk_histogram_t;
+
+extern void _dk_histogram_reset(dk_histogram_t* histogram);
+extern void _dk_histogram_record(dk_histogram_t* histogram, uint64_t value);
+extern uint64_t _dk_histogram_percentile(const dk_histogram_t* histogram, double percentile);
+
+#endif // DEAKO_HISTOGRAM_H
@@ -0,0 +1,205 @@
+#include "deako_pch.h"
+#include "deako_profiler.h"
+
+#ifdef DK_PROFILE
+
+#include "platform/deako_atomic.h"
+#include "platform/deako_thread.h"
+
+#include <malloc.h>
+
+#define DK_PROFILE_CAPACITY (1u << 15) // records per thread, oldest are overwritten
+#define DK_PROFILE_MASK (DK_PROFILE_CAPACITY - 1)
+
+typedef struct dk_profile_record {
+    const char* name;
+    uint64_t timestamp; // ns
+    dk_profile_phase phase;
+} dk_profile_record_t;
+
+/* Single producer ring owned by one thread. head is only ever advanced by the owner, the
+ * dump reads it before and after copying to find out which records were overwritten. */
+typedef struct dk_profile_buffer {
+    dk_profile_record_t records[DK_PROFILE_CAPACITY];
+    volatile uint64_t head;
+    struct dk_profile_buffer* next;
+    const char* thread_name;
+    uint32_t thread_id;
+} dk_profile_buffer_t;
+
+static void* volatile g_profile_buffers = NULL; // dk_profile_buffer_t list, push only
+static volatile uint32_t g_profile_generation = 1; // bumped by every shutdown
+
+/* A thread's buffer is only trusted while the generation it was made in is current, so a
+ * worker that outlived _dk_profiler_shutdown never writes into a freed buffer. */
+static DK_THREAD_LOCAL dk_profile_buffer_t* t_profile_buffer = NULL;
+static DK_THREAD_LOCAL uint32_t t_profile_generation = 0;
+
+static dk_profile_buffer_t* _dk_profile_buffer(void)
+{
+    uint32_t generation = dk_atomic_load_u32(&g_profile_generation);
+    if (t_profile_buffer && t_profile_generation == generation)
+    {
+        return t_profile_buffer;
+    }
+    t_profile_buffer = NULL;
+
+    dk_profile_buffer_t* buffer = malloc(sizeof(*buffer));
+    if (!buffer)
+    {
+        return NULL;
+    }
+
+    buffer->head        = 0;
+    buffer->thread_name = NULL;
+    buffer->thread_id   = dk_thread_id();
+
+    void* head = dk_atomic_load_ptr(&g_profile_buffers);
+    do
+    {
+        buffer->next = head;
+    } while (!dk_atomic_cas_ptr(&g_profile_buffers, &head, buffer));
+
+    t_profile_buffer     = buffer;
+    t_profile_generation = generation;
+    return buffer;
+}
+
+void _dk_profile_record(const char* name, dk_profile_phase phase)
+{
+    dk_profile_buffer_t* buffer = _dk_profile_buffer();
+    if (!buffer)
+    {
+        return;
+    }
+
+    uint64_t head               = buffer->head;
+    dk_profile_record_t* record = &buffer->records[head & DK_PROFILE_MASK];
+    record->name                = name;
+    record->timestamp           = dk_clock_now_ns();
+    record->phase               = phase;
+    dk_atomic_store_u64(&buffer->head, head + 1);
+}
+
+void dk_profile_thread_name(const char* name)
+{
+    dk_profile_buffer_t* buffer = _dk_profile_buffer();
+    if (buffer)
+    {
+        buffer->thread_name = name;
+    }
+}
+
+static void _dk_profile_write_string(FILE* file, const char* string)
+{
+    fputc('"', file);
+    for (; *string; string++)
+    {
+        if (*string == '"' || *string == '\\')
+        {
+            fputc('\\', file);
+        }
+        fputc((unsigned char)*string < 0x20 ? ' ' : *string, file);
+    }
+    fputc('"', file);
+}
+
+int dk_profile_dump(const char* path)
+{
+    DK_CHECK(path, DK_ERRNO_UNKNOWN);
+
+    FILE* file = fopen(path, "w");
+    DK_CHECK(file, DK_ERRNO_UNKNOWN);
+
+    dk_profile_record_t* snapshot = malloc(sizeof(dk_profile_record_t) * DK_PROFILE_CAPACITY);
+    if (!snapshot)
+    {
+        fclose(file);
+        DK_ERROR_HANDLE(DK_ERRNO_UNKNOWN);
+    }
+
+    const char* separator = "";
+    uint64_t count        = 0;
+    fprintf(file, "{\"traceEvents\":[");
+
+    for (dk_profile_buffer_t* buffer = dk_atomic_load_ptr(&g_profile_buffers); buffer; buffer = buffer->next)
+    {
+        if (buffer->thread_name)
+        {
+            fprintf(file, "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":",
+            separator, buffer->thread_id);
+            _dk_profile_write_string(file, buffer->thread_name);
+            fprintf(file, "}}");
+            separator = ",";
+        }
+
+        uint64_t end   = dk_atomic_load_u64(&buffer->head);
+        uint64_t begin = (end > DK_PROFILE_CAPACITY) ? end - DK_PROFILE_CAPACITY : 0;
+        for (uint64_t i = begin; i < end; i++)
+        {
+            snapshot[i & DK_PROFILE_MASK] = buffer->records[i & DK_PROFILE_MASK];
+        }
+
+        /* the owner may have lapped us while copying, drop whatever it overwrote */
+        dk_atomic_fence();
+        uint64_t head = dk_atomic_load_u64(&buffer->head);
+        if (head + 1 > begin + DK_PROFILE_CAPACITY)
+        {
+            begin = head + 1 - DK_PROFILE_CAPACITY;
+        }
+
+        for (uint64_t i = begin; i < end; i++)
+        {
+            const dk_profile_record_t* record = &snapshot[i & DK_PROFILE_MASK];
+            fprintf(file, "%s\n{\"name\":", separator);
+            _dk_profile_write_string(file, record->name ? record->name : "?");
+            fprintf(file, ",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":1,\"tid\":%u}",
+            record->phase == DK_PROFILE_PHASE_BEGIN ? 'B' : 'E', (double)record->timestamp / DK_NS_PER_US,
+            buffer->thread_id);
+            separator = ",";
+            count++;
+        }
+    }
+
+    fprintf(file, "\n],\"displayTimeUnit\":\"ns\"}\n");
+    fclose(file);
+    free(snapshot);
+
+    DK_INFO("profiler: wrote %llu events to %s", (unsigned long long)count, path);
+
+    return DK_STATUS_OK;
+}
+
+void _dk_profiler_shutdown(void)
+{
+    dk_atomic_add_u32(&g_profile_generation, 1);
+    dk_profile_buffer_t* buffer = dk_atomic_exchange_ptr(&g_profile_buffers, NULL);
+    while (buffer)
+    {
+        dk_profile_buffer_t* next = buffer->next;
+        free(buffer);
+        buffer = next;
+    }
+
+    t_profile_buffer = NULL;
+}
+
+#else
+
+void dk_profile_thread_name(const char* name)
+{
+    (void)name;
+}
+
+int dk_profile_dump(const char* path)
+{
+    (void)path;
+    DK_WARN("profiler: compiled out, define DK_PROFILE to record traces");
+    return DK_STATUS_OK;
+}
+
+void _dk_profiler_shutdown(void)
+{
+}
+
+#endif
@@ -0,0 +1,50 @@
+#ifndef DEAKO_PROFILER_H
+#define DEAKO_PROFILER_H
+
+#include <stdint.h>
+
+/* Scope profiler, compiled in when DK_PROFILE is defined (debug and release builds).
+ *
+ *     DK_PROFILE_SCOPE("physics")
+ *     {
+ *         ...
+ *     }
+ *
+ * Leaving a DK_PROFILE_SCOPE block with return/break/goto skips its end marker; use
+ * DK_PROFILE_BEGIN/END around code with early exits. */
+
+typedef enum dk_profile_phase {
+    DK_PROFILE_PHASE_BEGIN = 0,
+    DK_PROFILE_PHASE_END,
+} dk_profile_phase;
+
+#ifdef DK_PROFILE
+
+#define DK_PROFILE_BEGIN(name) _dk_profile_record((name), DK_PROFILE_PHASE_BEGIN)
+#define DK_PROFILE_END(name) _dk_profile_record((name), DK_PROFILE_PHASE_END)
+#define DK_PROFILE_SCOPE(name)                                                   \
+    for (int _dk_profile_once = (DK_PROFILE_BEGIN(name), 0); !_dk_profile_once; \
+    _dk_profile_once          = (DK_PROFILE_END(name), 1))
+
+extern void _dk_profile_record(const char* name, dk_profile_phase phase);
+
+#else
+
+#define DK_PROFILE_BEGIN(name) ((void)0)
+#define DK_PROFILE_END(name) ((void)0)
+#define DK_PROFILE_SCOPE(name)
+
+#endif
+
+/* label the calling thread in the trace, name must outlive the profiler */
+extern void dk_profile_thread_name(const char* name);
+
+/* writes everything still held in the per-thread rings as Chrome trace JSON
+ * (chrome://tracing, ui.perfetto.dev) */
+extern int dk_profile_dump(const char* path);
+
+/* Frees every thread's ring. Threads that record afterwards start a fresh one, but none may
+ * be recording while this runs. */
+extern void _dk_profiler_shutdown(void);
+
+#endif // DEAKO_PROFILER_H
@@ -1,21 +1,22 @@
 #include "deako_pch.h"
 #include "deako_renderer.h"
 
-#include <malloc.h>
+#define DK_RENDERER_ARENA_RESERVE (256ull * 1024 * 1024)
 
 static dk_renderer_t* g_renderer = NULL;
 
 int _dk_renderer_init(dk_renderer_t* module)
 {
-    g_renderer = malloc(sizeof(*g_renderer));
-    DK_CHECK(g_renderer, DK_ERRNO_UNKNOWN);
-    *g_renderer = *module;
+    g_renderer = module; // the registry's copy, lives as long as the app
+    int status = dk_module_arena_init((dk_module_t*)g_renderer, DK_RENDERER_ARENA_RESERVE);
+    DK_STATUS(status);
 
-    switch (g_renderer->flags)
+    switch (g_renderer->flags & ~DK_MODULE_FLAG_COMMON)
     {
-    case DK_RENDERER_FLAG_VULKAN: _dk_vulkan_init(); break;
+    case DK_RENDERER_FLAG_VULKAN: status = _dk_vulkan_init(); break;
     default: return DK_ERRNO_UNKNOWN;
     }
+    DK_STATUS(status);
 
     DK_DEBUG("Initialized: %s\n", g_renderer->name);
 
@@ -28,6 +29,12 @@ int _dk_renderer_init(dk_renderer_t* module)
 
 int _dk_renderer_shutdown(void)
 {
+    if (g_renderer)
+    {
+        dk_module_arena_shutdown((dk_module_t*)g_renderer);
+        g_renderer = NULL;
+    }
+
     return DK_STATUS_OK;
 }
 
@@ -8,13 +8,16 @@ workspace "deako"
         systemversion "latest"
         defines { "DK_PLATFORM_WINDOWS" }
 
+    filter "system:linux"
+        defines { "DK_PLATFORM_LINUX", "_GNU_SOURCE" }
+
     filter "configurations:debug"
-        defines { "DEBUG" }
+        defines { "DEBUG", "DK_PROFILE" }
         runtime "Debug"
         symbols "On"
 
     filter "configurations:release"
-        defines { "RELEASE" }
+        defines { "RELEASE", "DK_PROFILE" }
         runtime "Release"
         optimize "On"
         symbols "On"
@@ -32,7 +35,6 @@ workspace "deako"
 	IncludeDir["cglm"] = "%{wks.location}/vendors/cglm/include"
     IncludeDir["log"] = "%{wks.location}/vendors/log"
 	IncludeDir["glfw"] = "%{wks.location}/vendors/glfw/include"
-    IncludeDir["magic_memory"] = "%{wks.location}/vendors/magic_memory/magic_memory"
     IncludeDir["vulkan"] = "%{wks.location}/vendors/vulkan/1.3.296.0/Include"
 
     LibDir = {}
@@ -41,7 +43,6 @@ workspace "deako"
     group "vendors"
         include "vendors/log/premake5.lua"
 	    include "vendors/glfw/premake5.lua"
-        include "vendors/magic_memory/magic_memory/premake5.lua"
     group ""
 
     group "deako"
@@ -49,9 +50,16 @@ workspace "deako"
     group ""
 
     group "sandbox"
+	    include "sandbox/event_bus/premake5.lua"
 	    include "sandbox/event_system/premake5.lua"
+	    include "sandbox/pool_alloc/premake5.lua"
+	    include "sandbox/timer_wheel/premake5.lua"
     group ""
 
     group "tools"
 	    include "tools/deako_editor/premake5.lua"
+        if os.istarget("linux") then
+            include "tools/deako_editor/layers/premake5.lua"
+        end
+	    include "tools/deako_logdump/premake5.lua"
     group ""
\ No newline at end of file
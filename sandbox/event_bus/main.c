@@ -0,0 +1,114 @@
+#include "deako_internal.h"
+#include "event/deako_bus.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define BENCH_LAYERS 100
+#define BENCH_TYPES 50     // DK_REQUEST_TYPE_USER .. + 49
+#define BENCH_BATCH 4096   // requests per frame
+#define BENCH_FRAMES 1000
+#define BENCH_INTEREST 2   // topics each layer subscribes to
+
+static uint64_t g_received = 0;
+static uint64_t g_checksum = 0;
+
+/* stands in for a layer's on_request when the bus already filtered the batch */
+static void bench_on_topic(const dk_request_t* requests, uint32_t count)
+{
+	for (uint32_t i = 0; i < count; i++)
+	{
+		g_checksum += requests[i].data.user[0];
+	}
+	g_received += count;
+}
+
+/* the same layer when every request is broadcast: it has to skip what it does not want */
+static void bench_on_broadcast(uint64_t topics, const dk_request_t* requests, uint32_t count)
+{
+	for (uint32_t i = 0; i < count; i++)
+	{
+		if (topics & DK_TOPIC(requests[i].type))
+		{
+			g_checksum += requests[i].data.user[0];
+			g_received++;
+		}
+	}
+}
+
+static double bench_seconds(uint64_t begin)
+{
+	return (double)(dk_clock_now_ns() - begin) / DK_NS_PER_S;
+}
+
+int main()
+{
+	dk_arena_t arena;
+	dk_bus_subscriber_t subscribers[BENCH_LAYERS];
+	dk_request_t* batch = malloc(BENCH_BATCH * sizeof(*batch));
+	if (!batch || dk_arena_init_virtual(&arena, 64ull * 1024 * 1024, DK_ARENA_FLAG_NONE) != DK_STATUS_OK)
+	{
+		printf("event_bus: init failed\n");
+		return 1;
+	}
+
+	srand(1234);
+	for (uint32_t i = 0; i < BENCH_LAYERS; i++)
+	{
+		subscribers[i].on_request = bench_on_topic;
+		subscribers[i].topics = 0;
+		for (uint32_t k = 0; k < BENCH_INTEREST; k++)
+		{
+			subscribers[i].topics |= DK_TOPIC(DK_REQUEST_TYPE_USER + rand() % BENCH_TYPES);
+		}
+	}
+	for (uint32_t i = 0; i < BENCH_BATCH; i++)
+	{
+		batch[i] = (dk_request_t){ .type = DK_REQUEST_TYPE_USER + rand() % BENCH_TYPES };
+		batch[i].data.user[0] = i;
+	}
+
+	dk_bus_t bus;
+	if (_dk_bus_init(&bus, &arena, BENCH_BATCH, subscribers, BENCH_LAYERS) != DK_STATUS_OK)
+	{
+		printf("event_bus: bus init failed\n");
+		return 1;
+	}
+
+	uint64_t begin = dk_clock_now_ns();
+	for (uint32_t frame = 0; frame < BENCH_FRAMES; frame++)
+	{
+		for (uint32_t i = 0; i < BENCH_LAYERS; i++)
+		{
+			bench_on_broadcast(subscribers[i].topics, batch, BENCH_BATCH);
+		}
+	}
+	double broadcast = bench_seconds(begin);
+	uint64_t broadcast_received = g_received;
+	uint64_t broadcast_checksum = g_checksum;
+
+	g_received = 0;
+	g_checksum = 0;
+	begin = dk_clock_now_ns();
+	for (uint32_t frame = 0; frame < BENCH_FRAMES; frame++)
+	{
+		_dk_bus_publish(&bus, batch, BENCH_BATCH);
+	}
+	double published = bench_seconds(begin);
+
+	printf("%u layers, %u types, %u requests/frame, %u frames\n", BENCH_LAYERS, BENCH_TYPES, BENCH_BATCH, BENCH_FRAMES);
+	printf("broadcast: %8.3f ms/frame, %llu deliveries\n", broadcast * 1e3 / BENCH_FRAMES,
+		(unsigned long long)broadcast_received);
+	printf("bus:       %8.3f ms/frame, %llu deliveries, %llu calls (%.1fx)\n", published * 1e3 / BENCH_FRAMES,
+		(unsigned long long)g_received, (unsigned long long)bus.delivered, broadcast / published);
+
+	if (g_received != broadcast_received || g_checksum != broadcast_checksum)
+	{
+		printf("event_bus: deliveries differ\n");
+		return 1;
+	}
+
+	dk_arena_shutdown(&arena);
+	free(batch);
+	return 0;
+}
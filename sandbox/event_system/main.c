@@ -1,7 +1,139 @@
+#include "deako_internal.h"
+#include "event/deako_event.h"
+#include "platform/deako_thread.h"
 
+#include <stdio.h>
+#include <stdlib.h>
+
+#define BENCH_EVENTS 2000000 // per run, split across the producers
+#define BENCH_CAPACITY 16384 // per frame batch and ring
+#define BENCH_MAIN_BATCH 4096 // events the main thread posts per frame when it is the only producer
+#define BENCH_PRODUCERS_MAX 8
+#define BENCH_LISTENERS_MAX 64
+
+typedef struct bench_producer {
+	dk_thread_t thread;
+	dk_event_queue_t* queue;
+	uint32_t id;
+	uint32_t count;
+	uint64_t retries; // posts that found the queue full
+} bench_producer_t;
+
+static uint64_t g_checksums[BENCH_LISTENERS_MAX];
+
+/* stands in for a layer's on_request: looks at every request of the batch */
+static void bench_on_request(uint32_t listener, const dk_request_t* requests, uint32_t count)
+{
+	uint64_t sum = 0;
+	for (uint32_t i = 0; i < count; i++)
+	{
+		if (requests[i].type == DK_REQUEST_TYPE_USER)
+		{
+			sum += requests[i].data.user[0];
+		}
+	}
+	g_checksums[listener] += sum;
+}
+
+static void bench_produce(void* data)
+{
+	bench_producer_t* producer = data;
+	dk_request_t request = { .type = DK_REQUEST_TYPE_USER, .source = producer->id };
+
+	for (uint32_t i = 0; i < producer->count; i++)
+	{
+		request.data.user[0] = i;
+		while (!_dk_event_post(producer->queue, &request))
+		{
+			producer->retries++;
+			dk_thread_yield(); // wait for the next frame to drain the ring
+		}
+	}
+}
+
+/* Producers post BENCH_EVENTS user requests while the main thread runs frames back to
+ * back: collect the batch, hand it to every listener. 0 producers = the main thread posts
+ * on its own, the path window input takes. */
+static void bench_run(uint32_t producer_count, uint32_t listener_count)
+{
+	dk_arena_t arena;
+	dk_event_queue_t* queue = NULL;
+	if (dk_arena_init_virtual(&arena, 64ull * 1024 * 1024, DK_ARENA_FLAG_NONE) != DK_STATUS_OK ||
+		!(queue = dk_arena_alloc(&arena, sizeof(*queue), DK_CACHE_LINE)) ||
+		_dk_event_queue_init(queue, &arena, BENCH_CAPACITY) != DK_STATUS_OK)
+	{
+		printf("event_system: init failed\n");
+		exit(1);
+	}
+
+	bench_producer_t producers[BENCH_PRODUCERS_MAX];
+	uint64_t begin = dk_clock_now_ns();
+	for (uint32_t i = 0; i < producer_count; i++)
+	{
+		producers[i].queue = queue;
+		producers[i].id = i;
+		producers[i].count = BENCH_EVENTS / producer_count;
+		producers[i].retries = 0;
+		dk_thread_create(&producers[i].thread, bench_produce, &producers[i]);
+	}
+
+	uint64_t expected = producer_count ? (uint64_t)(BENCH_EVENTS / producer_count) * producer_count : BENCH_EVENTS;
+	uint64_t received = 0;
+	uint64_t frames = 0;
+	uint32_t posted = 0;
+	while (received < expected)
+	{
+		dk_request_t request = { .type = DK_REQUEST_TYPE_USER };
+		for (uint32_t i = 0; producer_count == 0 && i < BENCH_MAIN_BATCH && posted < BENCH_EVENTS; i++)
+		{
+			request.data.user[0] = posted++;
+			_dk_event_post(queue, &request);
+		}
+
+		const dk_request_t* requests;
+		uint32_t count = _dk_event_collect(queue, &requests);
+		for (uint32_t listener = 0; listener < listener_count; listener++)
+		{
+			bench_on_request(listener, requests, count);
+		}
+
+		received += count;
+		frames++;
+		if (count == 0)
+		{
+			dk_thread_yield();
+		}
+	}
+
+	uint64_t retries = 0;
+	for (uint32_t i = 0; i < producer_count; i++)
+	{
+		dk_thread_join(&producers[i].thread);
+		retries += producers[i].retries;
+	}
+	uint64_t elapsed = dk_clock_now_ns() - begin;
+
+	double seconds = (double)elapsed / DK_NS_PER_S;
+	printf("%u producers, %2u listeners: %6.1f M events/s, %7.1f M deliveries/s, %6llu frames, %llu full\n",
+		producer_count, listener_count, (double)received / seconds / 1e6,
+		(double)received * listener_count / seconds / 1e6, (unsigned long long)frames,
+		(unsigned long long)retries);
+
+	dk_arena_shutdown(&arena);
+}
 
 int main()
 {
+	static const uint32_t producers[] = { 0, 1, 2, 4, 8 };
+	static const uint32_t listeners[] = { 1, 8, 64 };
+
+	for (uint32_t p = 0; p < sizeof(producers) / sizeof(producers[0]); p++)
+	{
+		for (uint32_t l = 0; l < sizeof(listeners) / sizeof(listeners[0]); l++)
+		{
+			bench_run(producers[p], listeners[l]);
+		}
+	}
 
 	return 0;
-}
\ No newline at end of file
+}
@@ -12,11 +12,14 @@ project "sandbox"
    includedirs
    {
       "%{prj.location}", 
+      "%{IncludeDir.deako}",
+      "%{IncludeDir.log}",
       "%{IncludeDir.glfw}", 
    }
 
    links
    {
+      "deako",
    }
 
    filter { "language:C" }
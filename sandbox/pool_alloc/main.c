@@ -0,0 +1,124 @@
+#include "deako_internal.h"
+#include "memory/deako_pool.h"
+#include "platform/deako_thread.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BENCH_OPS 4000000 // alloc or free calls per thread
+#define BENCH_LIVE 256    // slots per thread, about half of them occupied at any time
+#define BENCH_SIZE 48     // a small engine record
+#define BENCH_THREADS_MAX 8
+
+typedef struct bench_thread {
+	dk_thread_t thread;
+	dk_pool_t* pool; // NULL = malloc
+	uint32_t seed;
+	uint64_t checksum;
+} bench_thread_t;
+
+static uint32_t bench_random(uint32_t* state)
+{
+	*state ^= *state << 13;
+	*state ^= *state >> 17;
+	*state ^= *state << 5;
+	return *state;
+}
+
+/* Random alloc/free churn over a fixed set of slots, each block written on alloc and read
+ * back on free so neither allocator gets away without touching its memory. */
+static void bench_churn(void* data)
+{
+	bench_thread_t* bench = data;
+	void* slots[BENCH_LIVE] = { 0 };
+
+	for (uint32_t i = 0; i < BENCH_OPS; i++)
+	{
+		uint32_t slot = bench_random(&bench->seed) % BENCH_LIVE;
+		if (slots[slot])
+		{
+			bench->checksum += *(uint32_t*)slots[slot];
+			if (bench->pool)
+			{
+				dk_pool_free(bench->pool, slots[slot]);
+			}
+			else
+			{
+				free(slots[slot]);
+			}
+			slots[slot] = NULL;
+		}
+		else
+		{
+			slots[slot] = bench->pool ? dk_pool_alloc(bench->pool) : malloc(BENCH_SIZE);
+			if (!slots[slot])
+			{
+				printf("pool_alloc: out of memory\n");
+				exit(1);
+			}
+			memset(slots[slot], (int)i, BENCH_SIZE);
+		}
+	}
+
+	for (uint32_t slot = 0; slot < BENCH_LIVE; slot++)
+	{
+		if (bench->pool)
+		{
+			dk_pool_free(bench->pool, slots[slot]);
+		}
+		else
+		{
+			free(slots[slot]);
+		}
+	}
+}
+
+static double bench_run(dk_pool_t* pool, uint32_t thread_count)
+{
+	bench_thread_t threads[BENCH_THREADS_MAX];
+
+	uint64_t begin = dk_clock_now_ns();
+	for (uint32_t i = 0; i < thread_count; i++)
+	{
+		threads[i].pool = pool;
+		threads[i].seed = 2463534242u + i;
+		threads[i].checksum = 0;
+		dk_thread_create(&threads[i].thread, bench_churn, &threads[i]);
+	}
+	for (uint32_t i = 0; i < thread_count; i++)
+	{
+		dk_thread_join(&threads[i].thread);
+	}
+	uint64_t elapsed = dk_clock_now_ns() - begin;
+
+	return (double)elapsed / ((double)BENCH_OPS * thread_count);
+}
+
+int main()
+{
+	dk_arena_t arena;
+	dk_pool_t pool;
+	if (dk_arena_init_virtual(&arena, 1ull << 30, DK_ARENA_FLAG_NONE) != DK_STATUS_OK ||
+		dk_pool_init(&pool, &arena, BENCH_SIZE, DK_ARENA_ALIGN) != DK_STATUS_OK)
+	{
+		printf("pool_alloc: init failed\n");
+		return 1;
+	}
+
+	for (uint32_t thread_count = 1; thread_count <= BENCH_THREADS_MAX; thread_count *= 2)
+	{
+		double heap = bench_run(NULL, thread_count);
+		double pooled = bench_run(&pool, thread_count);
+		printf("%2u threads: malloc %6.1f ns/op, pool %6.1f ns/op, %4.1fx\n", thread_count, heap, pooled,
+			heap / pooled);
+	}
+
+	printf("pool: %llu blocks carved, %.1f KiB of arena\n", (unsigned long long)pool.carved,
+		(double)arena.offset / 1024);
+
+	dk_pool_shutdown(&pool);
+	dk_arena_shutdown(&arena);
+
+	return 0;
+}
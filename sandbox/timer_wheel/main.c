@@ -0,0 +1,62 @@
+#include "app/deako_timer.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define BENCH_TICKS 60000 // 1 minute of wheel time at 1 ms per tick
+
+static uint64_t g_fired = 0;
+
+static void bench_on_timer(void)
+{
+	g_fired++;
+}
+
+/* N timers spread over the first minute, a quarter of them repeating, advanced one tick
+ * at a time with a cancel + reschedule of a random timer every tick to model churn. */
+static void bench_run(uint32_t timer_count)
+{
+	dk_timer_wheel_t* wheel = malloc(sizeof(*wheel));
+	dk_timer_handle_t* handles = malloc(timer_count * sizeof(*handles));
+	if (!wheel || !handles || _dk_timer_wheel_init(wheel, 0) != DK_STATUS_OK)
+	{
+		printf("timer_wheel: out of memory\n");
+		exit(1);
+	}
+
+	srand(1234);
+	for (uint32_t i = 0; i < timer_count; i++)
+	{
+		uint64_t delay = (uint64_t)(rand() % BENCH_TICKS + 1) * DK_NS_PER_MS;
+		uint64_t interval = (i % 4 == 0) ? (uint64_t)(rand() % 1000 + 1) * DK_NS_PER_MS : 0;
+		handles[i] = _dk_timer_wheel_schedule(wheel, delay, interval, bench_on_timer);
+	}
+
+	g_fired = 0;
+	uint64_t begin = dk_clock_now_ns();
+	for (uint64_t tick = 1; tick <= BENCH_TICKS; tick++)
+	{
+		uint32_t victim = (uint32_t)rand() % timer_count;
+		_dk_timer_wheel_cancel(wheel, handles[victim]);
+		handles[victim] = _dk_timer_wheel_schedule(
+			wheel, tick * DK_NS_PER_MS + (uint64_t)(rand() % BENCH_TICKS + 1) * DK_NS_PER_MS, 0, bench_on_timer);
+
+		_dk_timer_wheel_update(wheel, tick * DK_NS_PER_MS);
+	}
+	uint64_t elapsed = dk_clock_now_ns() - begin;
+
+	printf("%7u timers: %8.1f ns/tick, %10llu fired, %7u still active\n", timer_count,
+		(double)elapsed / BENCH_TICKS, (unsigned long long)g_fired, wheel->count);
+
+	_dk_timer_wheel_shutdown(wheel);
+	free(handles);
+	free(wheel);
+}
+
+int main()
+{
+	bench_run(10000);
+	bench_run(100000);
+
+	return 0;
+}
@@ -3,15 +3,27 @@
 
 #include "deako_editor.h"
 
+#include <stdlib.h>
+
 static dk_layer_t layers[] = {
-	{ "GUI", dk_editor_gui_on_update, dk_editor_gui_on_request },
-	{ "VIEWPORT", dk_editor_viewport_on_update, dk_editor_viewport_on_request }
+	{ .name = "GUI", .on_update = dk_editor_gui_on_update, .on_request = dk_editor_gui_on_request,
+		.reads = DK_EDITOR_RESOURCE_SCENE, .writes = DK_EDITOR_RESOURCE_GUI },
+	{ .name = "VIEWPORT", .on_update = dk_editor_viewport_on_update, .on_request = dk_editor_viewport_on_request,
+		.reads = DK_EDITOR_RESOURCE_SCENE, .writes = DK_EDITOR_RESOURCE_VIEWPORT }
 };
 
 dk_config_t dk_configure(void)
 {
+	/* DK_EDITOR_PLUGIN=libdeako_editor_layers.so takes the layers from there and reloads them on rebuild */
+	for (uint32_t i = 0; i < 2; i++)
+	{
+		layers[i].library = getenv("DK_EDITOR_PLUGIN");
+	}
+
 	return (dk_config_t) {
 		.app_name = "Deako Editor", .app_layers = layers,
-			.app_layer_count = 2, .window_width = 1200, .window_height = 900
+			.app_layer_count = 2, .window_width = 1200, .window_height = 900,
+			/* DK_RECORD=session.dkr to capture, DK_REPLAY=session.dkr to benchmark it headless */
+			.record_path = getenv("DK_RECORD"), .replay_path = getenv("DK_REPLAY")
 	};
 }
\ No newline at end of file
@@ -3,10 +3,15 @@
 
 // #include "deako.h"
 
+/* resources shared between editor layers, see dk_layer_t reads/writes */
+#define DK_EDITOR_RESOURCE_GUI DK_RESOURCE(0)
+#define DK_EDITOR_RESOURCE_VIEWPORT DK_RESOURCE(1)
+#define DK_EDITOR_RESOURCE_SCENE DK_RESOURCE(2)
+
 extern void dk_editor_gui_on_update(void);
-extern void dk_editor_gui_on_request(void);
+extern void dk_editor_gui_on_request(const dk_request_t* requests, uint32_t count);
 
 extern void dk_editor_viewport_on_update(void);
-extern void dk_editor_viewport_on_request(void);
+extern void dk_editor_viewport_on_request(const dk_request_t* requests, uint32_t count);
 
 #endif // DEAKO_EDITOR_H
\ No newline at end of file
@@ -0,0 +1,47 @@
+#include "deako.h"
+#include "../deako_editor.h"
+
+#include <string.h>
+
+/* Survives reloads in the layer's state arena. */
+typedef struct dk_editor_plugin_state {
+    uint32_t loads;
+} dk_editor_plugin_state_t;
+
+int dk_plugin_load(const char* layer, dk_plugin_t* plugin, dk_arena_t* state, bool reload)
+{
+    dk_editor_plugin_state_t* plugin_state = dk_plugin_state(state, sizeof(*plugin_state));
+    if (!plugin_state)
+    {
+        return DK_ERRNO_UNKNOWN;
+    }
+
+    if (strcmp(layer, "GUI") == 0)
+    {
+        plugin->on_update  = dk_editor_gui_on_update;
+        plugin->on_request = dk_editor_gui_on_request;
+    }
+    else if (strcmp(layer, "VIEWPORT") == 0)
+    {
+        plugin->on_update  = dk_editor_viewport_on_update;
+        plugin->on_request = dk_editor_viewport_on_request;
+    }
+    else
+    {
+        return DK_ERRNO_UNKNOWN;
+    }
+
+    plugin_state->loads++;
+    if (reload)
+    {
+        DK_APP_INFO("%s reloaded, load %u", layer, plugin_state->loads);
+    }
+
+    return DK_STATUS_OK;
+}
+
+void dk_plugin_unload(const char* layer, dk_arena_t* state)
+{
+    (void)layer;
+    (void)state;
+}
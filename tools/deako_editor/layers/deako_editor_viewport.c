@@ -6,6 +6,8 @@ void dk_editor_viewport_on_update(void)
     DK_APP_DEBUG("dk_editor_viewport_on_update");
 }
 
-void dk_editor_viewport_on_request(void)
+void dk_editor_viewport_on_request(const dk_request_t* requests, uint32_t count)
 {
+    (void)requests;
+    (void)count;
 }
\ No newline at end of file
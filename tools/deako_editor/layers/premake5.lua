@@ -0,0 +1,39 @@
+project "deako_editor_layers"
+   kind "SharedLib"
+   language "C"
+   cdialect "C99"
+   pic "On"
+
+   targetdir ("%{wks.location}/bin/" .. OutputDir .. "/%{prj.name}")
+   objdir ("%{wks.location}/bin/int/" .. OutputDir .. "/%{prj.name}")
+
+   files { "*.c", "../deako_editor.h" }
+
+   includedirs
+   {
+      "%{prj.location}", 
+      "%{IncludeDir.deako}",
+      "%{IncludeDir.cglm}",
+      "%{IncludeDir.log}",
+      "%{IncludeDir.glfw}", 
+      "%{IncludeDir.vulkan}", 
+   }
+
+   -- deako is not linked in, its symbols come from the editor that loads the library
+   filter "system:linux"
+      linkoptions
+      {
+         "-Wl,-Bsymbolic", -- the layers' own functions, not the editor's copies of them
+      }
+
+   filter { "language:C" }
+        warnings "Extra"         -- Enables most warnings
+
+   filter { "toolset:gcc or clang" }
+        buildoptions 
+        {
+            "-Wall",         -- Enable all common warnings
+            "-Wextra",       -- Enable extra warnings
+            "-pedantic",     -- Enforce strict C standard compliance
+            "-Werror"        -- Treat warnings as errors (optional)
+        }
@@ -8,6 +8,7 @@ project "deako_editor"
    objdir ("%{wks.location}/bin/int/" .. OutputDir .. "/%{prj.name}")
 
    files { "**.h", "**.c" }
+   removefiles { "layers/deako_editor_plugin.c" } -- the shared library's entry points, the layers stay linked in
 
    includedirs
    {
@@ -16,7 +17,6 @@ project "deako_editor"
       "%{IncludeDir.cglm}",
       "%{IncludeDir.log}",
       "%{IncludeDir.glfw}", 
-      "%{IncludeDir.magic_memory}",
       "%{IncludeDir.vulkan}", 
    }
 
@@ -31,6 +31,12 @@ project "deako_editor"
       "vulkan-1",
    }
 
+   filter "system:linux"
+      linkoptions
+      {
+         "-rdynamic", -- hot-reloaded layer libraries resolve deako against the editor
+      }
+
    filter "system:windows"
       systemversion "latest"
       defines
@@ -0,0 +1,34 @@
+#include "deako_internal.h"
+
+#include <stdio.h>
+#include <string.h>
+
+/* Decodes binary logs written with dk_config_t.log_binary back into text. */
+int main(int argc, char** argv)
+{
+	if (argc < 2 || argc > 3)
+	{
+		fprintf(stderr, "usage: %s <binary log> [output]\n", argv[0]);
+		return 1;
+	}
+
+	FILE* output = stdout;
+	if (argc == 3 && strcmp(argv[2], "-") != 0)
+	{
+		output = fopen(argv[2], "w");
+		if (!output)
+		{
+			fprintf(stderr, "cannot open %s\n", argv[2]);
+			return 1;
+		}
+	}
+
+	int status = dk_log_decode(argv[1], output);
+
+	if (output != stdout)
+	{
+		fclose(output);
+	}
+
+	return status == DK_STATUS_OK ? 0 : 1;
+}
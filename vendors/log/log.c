@@ -146,7 +146,20 @@ static void init_event(log_Event *ev, void *udata) {
 }
 
 
+bool log_enabled(int level) {
+	return !L.quiet && level >= L.level;
+}
+
+
 void log_log(int level, const char *file, int line, const char *fmt, ...) {
+	va_list ap;
+	va_start(ap, fmt);
+	log_logv(level, file, line, fmt, ap);
+	va_end(ap);
+}
+
+
+void log_logv(int level, const char *file, int line, const char *fmt, va_list ap) {
 	log_Event ev = {
 	  .fmt = fmt,
 	  .file = file,
@@ -158,7 +171,7 @@ void log_log(int level, const char *file, int line, const char *fmt, ...) {
 
 	if (!L.quiet && level >= L.level) {
 		init_event(&ev, stderr);
-		va_start(ev.ap, fmt);
+		va_copy(ev.ap, ap);
 		stdout_callback(&ev);
 		va_end(ev.ap);
 	}
@@ -167,7 +180,7 @@ void log_log(int level, const char *file, int line, const char *fmt, ...) {
 		Callback *cb = &L.callbacks[i];
 		if (level >= cb->level) {
 			init_event(&ev, cb->udata);
-			va_start(ev.ap, fmt);
+			va_copy(ev.ap, ap);
 			cb->fn(&ev);
 			va_end(ev.ap);
 		}
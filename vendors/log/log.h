@@ -38,7 +38,9 @@ void log_set_level(int level);
 void log_set_quiet(bool enable);
 int log_add_callback(log_LogFn fn, void *udata, int level);
 int log_add_fp(FILE *fp, int level);
+bool log_enabled(int level);
 
 void log_log(int level, const char *file, int line, const char *fmt, ...);
+void log_logv(int level, const char *file, int line, const char *fmt, va_list ap);
 
 #endif
\ No newline at end of file